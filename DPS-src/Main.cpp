@@ -25,6 +25,9 @@ SOFTWARE.
 #include <signal.h>
 
 #include "parallel/DetParallelSolver.h"
+#include "parallel/BatchSolver.h"
+#include "parallel/SolverDaemon.h"
+#include "parallel/CubeSolver.h"
 #include "parallel/Version.h"
 #include "utils/System.h"
 
@@ -72,7 +75,19 @@ int main(int argc, char** argv) {
             cout << endl;
         }
 
-        SATResult ret = dps.solve();
+        if (dps.getOptions().getBatch()) {
+            dps_solver = nullptr;
+            BatchSolver batch(dps.getOptions());
+            exit(batch.run());
+        }
+        if (!dps.getOptions().getDaemon().empty()) {
+            dps_solver = nullptr;
+            SolverDaemon daemon(dps.getOptions());
+            exit(daemon.run());
+        }
+
+        SATResult ret = dps.getOptions().getCube() ? CubeSolver(dps).solve() : dps.solve();
+        dps.printResult();
         exit(ret);
 
     } catch (std::exception& e) {
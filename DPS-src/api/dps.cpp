@@ -0,0 +1,161 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "dps.h"
+#include "../parallel/DetParallelSolver.h"
+
+using namespace DPS;
+
+struct dps_solver {
+    DetParallelSolver       dps;
+    std::vector<int>        clause;     // literals of the current clause (dps_add)
+    std::vector<int>        assumptions; // assumptions of the next call of dps_solve
+    std::vector<int>        failed;     // failed assumptions of the last UNSAT result (sorted)
+    std::unique_ptr<Model>  model;      // model of the last SAT result (extracted at the first dps_val)
+    StatsRecord             stats;      // statistics of the last call of dps_solve
+    std::string             error;
+    std::string             add_error;  // error of dps_add, dps_add_clause or dps_assume (reported by dps_solve)
+};
+
+// the library is quiet unless the verbose level is given
+static const char* const quiet_option = "--verbose=0";
+
+dps_solver* dps_init(void) {
+    try {
+        dps_solver *s = new dps_solver;
+        s->dps.setOptions(std::vector<std::string>{ quiet_option });
+        return s;
+    } catch (std::exception&) {
+        return nullptr;
+    }
+}
+
+void dps_release(dps_solver *s) {
+    delete s;
+}
+
+const char* dps_error(const dps_solver *s) {
+    return s->error.c_str();
+}
+
+int dps_set_options(dps_solver *s, int argc, const char * const *argv) {
+    try {
+        std::vector<std::string> args(1, quiet_option);
+        args.insert(args.end(), argv, argv + argc);
+        s->dps.setOptions(args);
+        return 0;
+    } catch (std::exception& e) {
+        s->error = e.what();
+        return -1;
+    }
+}
+
+void dps_set_reuse_threads(dps_solver *s, int reuse) {
+    s->dps.setReuseThreads(reuse != 0);
+}
+
+void dps_set_incremental(dps_solver *s, int incremental) {
+    s->dps.setIncremental(incremental != 0);
+}
+
+// Exceptions must not cross the C ABI. The functions without a return value keep the error, which
+// makes the next calls of dps_solve fail since a clause or an assumption has been lost.
+static void setAddError(dps_solver *s, const std::exception& e) {
+    s->error = e.what();
+    if (s->add_error.empty())
+        s->add_error = e.what();
+}
+
+void dps_add(dps_solver *s, int lit) {
+    try {
+        if (lit != 0) {
+            s->clause.push_back(lit);
+            return;
+        }
+        s->dps.addClause(s->clause);
+        s->clause.clear();
+    } catch (std::exception& e) {
+        s->clause.clear();
+        setAddError(s, e);
+    }
+}
+
+void dps_add_clause(dps_solver *s, const int *lits, size_t size) {
+    try {
+        s->dps.addClause(lits, size);
+    } catch (std::exception& e) {
+        setAddError(s, e);
+    }
+}
+
+int64_t dps_add_clauses(dps_solver *s, const int *lits, size_t num_lits) {
+    try {
+        return s->dps.addClauses(lits, num_lits);
+    } catch (std::exception& e) {
+        setAddError(s, e);
+        return -1;
+    }
+}
+
+void dps_assume(dps_solver *s, int lit) {
+    try {
+        s->assumptions.push_back(lit);
+    } catch (std::exception& e) {
+        setAddError(s, e);
+    }
+}
+
+int dps_solve(dps_solver *s, double time_lim, uint64_t conflict_lim) {
+    if (!s->add_error.empty()) {
+        s->error = "a clause or an assumption has been lost (" + s->add_error + ")";
+        return -1;
+    }
+    if (!s->clause.empty()) {
+        s->error = "the last clause is not terminated by 0";
+        return -1;
+    }
+    s->model.reset();
+    s->failed.clear();
+    s->stats = StatsRecord();
+    std::vector<int> assumptions;
+    assumptions.swap(s->assumptions);
+    try {
+        SATResult res = s->dps.solve(assumptions, SolveLimits(time_lim, conflict_lim));
+        s->dps.collectStats(s->stats);
+        if (res == UNSAT) {
+            s->failed = s->dps.getFailedAssumptions();
+            std::sort(s->failed.begin(), s->failed.end());
+        }
+        return res;
+    } catch (std::exception& e) {
+        s->error = e.what();
+        return -1;
+    }
+}
+
+int dps_val(dps_solver *s, int lit) {
+    if (s->dps.getResult() != SAT) return 0;
+    if (!s->model) s->model.reset(new Model(s->dps.getModel()));
+    uint64_t var = std::abs((int64_t)lit);
+    if (var == 0 || var > s->model->getNumVars() || !s->model->isAssigned(var)) return 0;
+    return s->model->value(lit) ? lit : -lit;
+}
+
+int dps_failed(dps_solver *s, int lit) {
+    return std::binary_search(s->failed.begin(), s->failed.end(), lit) ? 1 : 0;
+}
+
+int dps_stat(dps_solver *s, const char *name, double *value) {
+    StatsRecord::Value v;
+    if (!s->stats.get(name, v) || (v.type != StatsRecord::Value::INT && v.type != StatsRecord::Value::REAL)) {
+        s->error = std::string("no numeric statistic '") + name + "'";
+        return -1;
+    }
+    *value = v.type == StatsRecord::Value::INT ? (double)v.i : v.d;
+    return 0;
+}
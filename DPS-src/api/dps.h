@@ -0,0 +1,66 @@
+#ifndef _DPS_API_H_
+#define _DPS_API_H_
+
+// C API of DPS for embedding the solver in other programs (libdps). A solver accumulates clauses
+// over calls of dps_solve(), and each call solves all of them from scratch (or incrementally, see
+// dps_set_incremental). Functions that can fail return a negative value and set the message
+// returned by dps_error().
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct dps_solver dps_solver;
+
+// creates a solver with the default options (nothing is printed unless '-v N' is given)
+dps_solver* dps_init(void);
+void        dps_release(dps_solver *s);
+// the message of the last error
+const char* dps_error(const dps_solver *s);
+
+// sets the options of the command line 'argv[0] ... argv[argc-1]' (without the program name,
+// e.g., "-n", "8", "--solver=kissat"), which replace all options set before (0 or -1)
+int  dps_set_options(dps_solver *s, int argc, const char * const *argv);
+// keeps the worker threads alive across calls of dps_solve() (off by default)
+void dps_set_reuse_threads(dps_solver *s, int reuse);
+// keeps the base solvers with their learnt clauses across calls of dps_solve() (off by default).
+// The results are deterministic for a given sequence of calls. Not supported by kissat.
+void dps_set_incremental(dps_solver *s, int incremental);
+
+// adds a literal of the current clause, which is closed by 0 (as in IPASIR)
+void dps_add(dps_solver *s, int lit);
+// adds a clause of 'size' literals
+void dps_add_clause(dps_solver *s, const int *lits, size_t size);
+// adds the 0-terminated clauses in 'lits[0] ... lits[num_lits-1]' (returns # of added clauses
+// or -1)
+int64_t dps_add_clauses(dps_solver *s, const int *lits, size_t num_lits);
+// NOTE: if dps_add, dps_add_clause, dps_add_clauses or dps_assume fails (e.g., out of memory), the
+// error is kept and all later calls of dps_solve() return -1.
+
+// assumes 'lit' to be true in the next call of dps_solve() (as in IPASIR, the assumptions are
+// cleared after the call; not supported by kissat)
+void dps_assume(dps_solver *s, int lit);
+
+// solves the clauses within the limits (0 for unlimited); 'conflict_lim' is the # of conflicts
+// of each thread in this call checked at the end of its periods and restarts, which keeps the
+// result deterministic.
+// Returns 10 (SAT), 20 (UNSAT), 0 (unknown) or -1 (error).
+int  dps_solve(dps_solver *s, double time_lim, uint64_t conflict_lim);
+// the value of 'lit' in the model of the last SAT result: 'lit' if true, '-lit' if false, and
+// 0 if unassigned or out of the model
+int  dps_val(dps_solver *s, int lit);
+// 1 if 'lit' is an assumption used to derive the last UNSAT result by the winner thread, otherwise
+// 0 (no assumption is used if the clauses are UNSAT without assumptions)
+int  dps_failed(dps_solver *s, int lit);
+// the statistic printed as 'name' (e.g., "Conflicts_total", "Winner", "RealTime") after the
+// last call of dps_solve() (0 or -1 if not found)
+int  dps_stat(dps_solver *s, const char *name, double *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
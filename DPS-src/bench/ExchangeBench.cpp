@@ -0,0 +1,309 @@
+// Microbenchmark of the clause exchange layer (ClauseBuffer, PrdClauses, PrdClausesQueue and
+// Sharer) driven by synthetic threads. Each thread repeats the period cycle of AbstDetSeqSolver:
+// it works for a given time while staging clauses with random sizes and LBDs, exports the staged
+// clauses to its period buffer, completes the period and imports the clauses of the period
+// 'margin' periods before from the other threads (waiting for slower threads if necessary).
+//
+//   dps-exchange-bench -n 8 --periods 2000 --period-us 200 --skew 1,1,1,2
+//
+// Reports throughput of exchanged clauses, latency percentiles (from the completion of a period
+// by its producer to the import by a consumer), waiting and exchanging time, and memory.
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "../parallel/Sharer.h"
+#include "../period/ClauseBuffer.h"
+#include "../utils/Stats.h"
+#include "../utils/System.h"
+#include "../utils/cxxopts.hpp"
+
+using namespace DPS;
+using std::cout;
+using std::endl;
+using std::string;
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t nanos(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+struct BenchConfig {
+    uint32_t            num_threads;
+    uint64_t            periods;
+    uint32_t            margin;
+    double              period_us;      // working time of a period of a thread with skew 1
+    std::vector<double> skews;          // working time factors of threads (assigned cyclically)
+    uint32_t            clauses;        // # of clauses generated per period
+    double              size_mean;      // mean size of generated clauses (>= 2)
+    uint32_t            size_max;
+    double              lbd_mean;       // mean LBD of generated clauses (>= 1)
+    uint32_t            lbd_lim;        // clauses with LBD <= lbd_lim are staged (0 for all)
+    uint32_t            exp_lits_lim;   // # of literals exported per period (0 for unlimited)
+    uint32_t            num_vars;
+    uint64_t            seed;
+};
+
+struct ThreadResult {
+    uint64_t              generated      = 0;
+    uint64_t              exported       = 0;
+    uint64_t              exported_lits  = 0;
+    uint64_t              imported       = 0;
+    uint64_t              imported_lits  = 0;
+    double                working_time   = 0;
+    double                exporting_time = 0;
+    double                importing_time = 0;
+    double                waiting_time   = 0;
+    std::vector<uint64_t> latencies;    // [ns] from the completion of a period to its import
+};
+
+class ExchangeBench {
+    const BenchConfig&                  config;
+    Sharer                              sharer;
+    std::vector<std::vector<uint64_t>>  completed_at;   // [thread][period] completion time in ns
+    std::vector<ThreadResult>           results;
+
+    void run(uint32_t thn);
+
+public:
+    ExchangeBench(const BenchConfig& c) :
+        config(c)
+    ,   sharer(c.num_threads, c.margin, 0, false)
+    ,   completed_at(c.num_threads, std::vector<uint64_t>(c.periods + 1))
+    ,   results(c.num_threads)
+    {}
+
+    double execute();
+    void   report(StatsRecord& stats, double elapsed) const;
+};
+
+void ExchangeBench::run(uint32_t thn) {
+    ThreadResult& res = results[thn];
+    PrdClausesQueue& own_queue = sharer.get(thn);
+    ClauseBuffer buf;
+    std::vector<Clause> imported;
+
+    std::mt19937_64 rng(config.seed + thn);
+    std::geometric_distribution<uint32_t> size_dist(1.0 / std::max(1.0, config.size_mean - 1.0));
+    std::geometric_distribution<uint32_t> lbd_dist (1.0 / std::max(1.0, config.lbd_mean));
+    std::uniform_int_distribution<int>    var_dist (1, config.num_vars);
+    const double skew = config.skews[thn % config.skews.size()];
+    const auto   work = std::chrono::duration<double, std::micro>(config.period_us * skew);
+    res.latencies.reserve(config.periods * (config.num_threads - 1));
+
+    for (uint64_t prd = 0; prd < config.periods; prd++) {
+        // work (busy) while generating clauses, like a base solver
+        Clock::time_point start = Clock::now();
+        Clock::time_point end   = start + std::chrono::duration_cast<Clock::duration>(work);
+        for (uint32_t i = 0; i < config.clauses; i++) {
+            uint32_t size = std::min<uint32_t>(config.size_max, 2 + size_dist(rng));
+            uint32_t lbd  = std::min<uint32_t>(size, 1 + lbd_dist(rng));
+            res.generated++;
+            if (config.lbd_lim > 0 && lbd > config.lbd_lim) continue;
+            int *lits = buf.reserve(size, size);
+            for (uint32_t j = 0; j < size; j++)
+                lits[j] = rng() & 1 ? var_dist(rng) : -var_dist(rng);
+            buf.commit();
+        }
+        while (Clock::now() < end) ;
+        Clock::time_point t0 = Clock::now();
+        res.working_time += std::chrono::duration<double>(t0 - start).count();
+
+        // export
+        PrdClauses& last = own_queue.last();
+        uint32_t before = last.getNumLiterals();
+        res.exported += buf.exportTo(last, config.exp_lits_lim);
+        res.exported_lits += last.getNumLiterals() - before;
+        completed_at[thn][prd] = nanos(Clock::now());
+        sharer.completeCurrPeriod(thn, 0);
+        Clock::time_point t1 = Clock::now();
+        res.exporting_time += std::chrono::duration<double>(t1 - t0).count();
+
+        // import the clauses of period 'prd - margin' (see AbstDetSeqSolver::importClauses)
+        if (prd < config.margin) continue;
+        uint64_t target_prd = prd - config.margin;
+        imported.clear();
+        for (uint32_t i = 1; i < config.num_threads; i++) {
+            uint32_t target = (thn + i) % config.num_threads;
+            PrdClausesQueue& queue = sharer.get(target);
+            PrdClauses* p = NULL;
+            while ((p = queue.get(thn, target_prd)) != NULL) {
+                PrdClauses& prdClauses = *p;
+                if (!prdClauses.isAdditionCompleted()) {
+                    Clock::time_point w = Clock::now();
+                    prdClauses.waitAdditionCompleted();
+                    res.waiting_time += std::chrono::duration<double>(Clock::now() - w).count();
+                }
+                uint64_t now = nanos(Clock::now());
+                uint64_t done = completed_at[target][prdClauses.period()];
+                res.latencies.push_back(now > done ? now - done : 0);
+                for (int j = 0; j < prdClauses.size(); j++) {
+                    const ClauseView c = prdClauses[j];
+                    imported.emplace_back(c.begin(), c.end());
+                    res.imported_lits += c.size();
+                }
+                res.imported += prdClauses.size();
+                queue.completeExportation(thn, prdClauses);
+            }
+        }
+        res.importing_time += std::chrono::duration<double>(Clock::now() - t1).count();
+    }
+    res.importing_time -= res.waiting_time;
+}
+
+double ExchangeBench::execute() {
+    std::vector<std::thread> threads;
+    double start = realTime();
+    for (uint32_t i = 0; i < config.num_threads; i++)
+        threads.emplace_back(&ExchangeBench::run, this, i);
+    for (std::thread& t : threads)
+        t.join();
+    return realTime() - start;
+}
+
+static double percentile(const std::vector<uint64_t>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t i = std::min(sorted.size() - 1, (size_t)(q * sorted.size()));
+    return sorted[i] / 1e3;     // in microseconds
+}
+
+void ExchangeBench::report(StatsRecord& stats, double elapsed) const {
+    std::vector<uint64_t> latencies;
+    uint64_t imported = 0, imported_lits = 0;
+
+    stats.section("Threads", 2);
+    for (uint32_t i = 0; i < config.num_threads; i++) {
+        const ThreadResult& r = results[i];
+        stats.set(i, "Generated",     r.generated);
+        stats.set(i, "Exported",      r.exported);
+        stats.set(i, "ExportedLits",  r.exported_lits);
+        stats.set(i, "Imported",      r.imported);
+        stats.set(i, "ImportedLits",  r.imported_lits);
+        stats.set(i, "WorkingTime",   r.working_time);
+        stats.set(i, "ExportingTime", r.exporting_time);
+        stats.set(i, "ImportingTime", r.importing_time);
+        stats.set(i, "WaitingTime",   r.waiting_time);
+        latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+        imported      += r.imported;
+        imported_lits += r.imported_lits;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    stats.section("Exchange", 1);
+    stats.set("Threads",         config.num_threads);
+    stats.set("Periods",         config.periods);
+    stats.set("Margin",          config.margin);
+    stats.set("RealTime",        elapsed);
+    stats.set("PeriodsPerSec",   StatsRecord::Value(config.periods / elapsed, 1));
+    stats.set("ClausesPerSec",   StatsRecord::Value(imported / elapsed, 1));
+    stats.set("LiteralsPerSec",  StatsRecord::Value(imported_lits / elapsed, 1));
+    stats.set("LatencyP50",      StatsRecord::Value(percentile(latencies, 0.50), 1));
+    stats.set("LatencyP90",      StatsRecord::Value(percentile(latencies, 0.90), 1));
+    stats.set("LatencyP99",      StatsRecord::Value(percentile(latencies, 0.99), 1));
+    stats.set("LatencyMax",      StatsRecord::Value(latencies.empty() ? 0.0 : latencies.back() / 1e3, 1));
+    double waiting = 0, exchanging = 0;
+    for (const ThreadResult& r : results) {
+        waiting    += r.waiting_time;
+        exchanging += r.exporting_time + r.importing_time;
+    }
+    stats.set("WaitingTime",     waiting);
+    stats.set("ExchangingTime",  exchanging);
+    stats.set("UsedMemory",      usedMemory());
+    stats.set("PeakMemory",      peakMemory());
+}
+
+static std::vector<double> parseSkews(const string& spec) {
+    std::vector<double> skews;
+    std::stringstream ss(spec);
+    string item;
+    while (std::getline(ss, item, ',')) {
+        size_t pos = 0;
+        double v = 0;
+        try { v = std::stod(item, &pos); } catch (std::exception&) { pos = 0; }
+        if (pos == 0 || pos != item.size() || v <= 0)
+            throw std::runtime_error("invalid skew '" + item + "' (expected positive numbers separated by commas)");
+        skews.push_back(v);
+    }
+    if (skews.empty())
+        throw std::runtime_error("empty skew spec");
+    return skews;
+}
+
+int main(int argc, char** argv) {
+    cxxopts::Options options("dps-exchange-bench", "Microbenchmark of the clause exchange layer of DPS");
+    options.add_options()
+        ("h,help",       "print this list of all command line options")
+        ("n,nthreads",   "number of threads",                                      cxxopts::value<uint32_t>()->default_value("4"),    "N")
+        ("periods",      "number of periods of each thread",                       cxxopts::value<uint64_t>()->default_value("1000"), "N")
+        ("m,margin",     "margin for delayed clause exchange",                     cxxopts::value<uint32_t>()->default_value("20"),   "N")
+        ("period-us",    "working time of a period [us]",                          cxxopts::value<double>()->default_value("100"),    "N")
+        ("skew",         "working time factors of threads assigned cyclically (e.g., '1,1,1,2')", cxxopts::value<string>()->default_value("1"), "LIST")
+        ("clauses",      "number of clauses generated per period",                 cxxopts::value<uint32_t>()->default_value("50"),   "N")
+        ("size-mean",    "mean size of generated clauses (geometric distribution)", cxxopts::value<double>()->default_value("8"),     "N")
+        ("size-max",     "maximum size of generated clauses",                      cxxopts::value<uint32_t>()->default_value("100"),  "N")
+        ("lbd-mean",     "mean LBD of generated clauses (geometric distribution)", cxxopts::value<double>()->default_value("4"),      "N")
+        ("lbd-lim",      "LBD upperbound of staged clauses (0 for unlimited)",     cxxopts::value<uint32_t>()->default_value("6"),    "N")
+        ("exp-lits-lim", "number of exported literals per period (0 for unlimited)", cxxopts::value<uint32_t>()->default_value("150"), "N")
+        ("vars",         "number of variables",                                    cxxopts::value<uint32_t>()->default_value("100000"), "N")
+        ("seed",         "random seed",                                            cxxopts::value<uint64_t>()->default_value("0"),    "N")
+        ("v,verbose",    "verbose level (2 for per-thread stats)",                 cxxopts::value<uint32_t>()->default_value("1"),    "N")
+        ("stats-json",   "write the statistics to FILE in JSON",                   cxxopts::value<string>()->default_value(""),       "FILE")
+    ;
+    try {
+        auto result = options.parse(argc, argv);
+        if (result.count("help")) {
+            cout << options.help() << endl;
+            return 0;
+        }
+        BenchConfig config;
+        config.num_threads  = result["nthreads"    ].as<uint32_t>();
+        config.periods      = result["periods"     ].as<uint64_t>();
+        config.margin       = result["margin"      ].as<uint32_t>();
+        config.period_us    = result["period-us"   ].as<double>();
+        config.skews        = parseSkews(result["skew"].as<string>());
+        config.clauses      = result["clauses"     ].as<uint32_t>();
+        config.size_mean    = result["size-mean"   ].as<double>();
+        config.size_max     = result["size-max"    ].as<uint32_t>();
+        config.lbd_mean     = result["lbd-mean"    ].as<double>();
+        config.lbd_lim      = result["lbd-lim"     ].as<uint32_t>();
+        config.exp_lits_lim = result["exp-lits-lim"].as<uint32_t>();
+        config.num_vars     = result["vars"        ].as<uint32_t>();
+        config.seed         = result["seed"        ].as<uint64_t>();
+        if (config.num_threads < 2)
+            throw std::runtime_error("# of threads must be >= 2");
+        if (config.margin < 1)
+            throw std::runtime_error("margin must be >= 1");
+        if (config.size_max < 2 || config.num_vars < 1)
+            throw std::runtime_error("size-max must be >= 2 and vars must be >= 1");
+
+        ExchangeBench bench(config);
+        double elapsed = bench.execute();
+        StatsRecord stats;
+        bench.report(stats, elapsed);
+        stats.print(result["verbose"].as<uint32_t>());
+
+        const string json = result["stats-json"].as<string>();
+        if (!json.empty()) {
+            FILE *fp = fopen(json.c_str(), "w");
+            if (!fp)
+                throw std::runtime_error("could not open '" + json + "'");
+            stats.writeJSON(fp, false);
+            fclose(fp);
+        }
+    } catch (cxxopts::OptionException& e) {
+        cout << "c Error: " << e.what() << " (try '-h')" << endl;
+        return 1;
+    } catch (std::exception& e) {
+        cout << "c Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+// Generator of the CNF corpus of the performance regression harness (see regress.sh). The
+// instances depend only on the parameters (the random generator is implemented here instead of
+// <random> distributions whose results differ among standard libraries).
+//
+//   dps-gen-cnf rand K N RATIO SEED      random K-SAT with N variables and N*RATIO clauses
+//   dps-gen-cnf php N                    pigeonhole principle of N+1 pigeons and N holes (UNSAT)
+//   dps-gen-cnf parity N SEED sat|unsat  two XOR chains over N variables in different orders
+//   dps-gen-cnf color N DEG K SEED       K-colouring of a random graph of N vertices and mean degree DEG
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+using std::string;
+using std::vector;
+
+// splitmix64
+class Random {
+    uint64_t state;
+public:
+    Random(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    uint32_t below(uint32_t n) { return next() % n; }
+};
+
+class CNF {
+    uint32_t            num_vars = 0;
+    vector<vector<int>> clauses;
+public:
+    int  newVar() { return ++num_vars; }
+    void setNumVars(uint32_t n) { num_vars = n; }
+    void add(const vector<int>& c) { clauses.push_back(c); }
+    void write(FILE *fp, const string& comment) const {
+        fprintf(fp, "c %s\n", comment.c_str());
+        fprintf(fp, "p cnf %u %zu\n", num_vars, clauses.size());
+        for (const vector<int>& c : clauses) {
+            for (int lit : c) fprintf(fp, "%d ", lit);
+            fprintf(fp, "0\n");
+        }
+    }
+};
+
+static void genRandom(CNF& cnf, uint32_t k, uint32_t n, double ratio, uint64_t seed) {
+    if (k < 1 || k > n) throw std::runtime_error("K must be in [1, N]");
+    Random rnd(seed);
+    cnf.setNumVars(n);
+    uint64_t m = (uint64_t)std::llround(n * ratio);
+    vector<int> c;
+    for (uint64_t i = 0; i < m; i++) {
+        c.clear();
+        while (c.size() < k) {
+            int v = 1 + rnd.below(n);
+            bool dup = false;
+            for (int lit : c) if (std::abs(lit) == v) dup = true;
+            if (!dup) c.push_back(rnd.below(2) ? v : -v);
+        }
+        cnf.add(c);
+    }
+}
+
+static void genPigeonhole(CNF& cnf, uint32_t n) {
+    // p(i, j): pigeon i is in hole j
+    auto p = [n](uint32_t i, uint32_t j) { return (int)(i * n + j + 1); };
+    cnf.setNumVars((n + 1) * n);
+    for (uint32_t i = 0; i <= n; i++) {
+        vector<int> c;
+        for (uint32_t j = 0; j < n; j++) c.push_back(p(i, j));
+        cnf.add(c);
+    }
+    for (uint32_t j = 0; j < n; j++)
+        for (uint32_t i1 = 0; i1 <= n; i1++)
+            for (uint32_t i2 = i1 + 1; i2 <= n; i2++)
+                cnf.add({ -p(i1, j), -p(i2, j) });
+}
+
+// z = x xor y
+static void addXor(CNF& cnf, int z, int x, int y) {
+    cnf.add({ -z,  x,  y });
+    cnf.add({ -z, -x, -y });
+    cnf.add({  z, -x,  y });
+    cnf.add({  z,  x, -y });
+}
+
+static void genParity(CNF& cnf, uint32_t n, uint64_t seed, bool sat) {
+    if (n < 2) throw std::runtime_error("N must be >= 2");
+    Random rnd(seed);
+    cnf.setNumVars(n);
+    for (int chain = 0; chain < 2; chain++) {
+        vector<int> order(n);
+        for (uint32_t i = 0; i < n; i++) order[i] = i + 1;
+        if (chain == 1)     // Fisher-Yates shuffle
+            for (uint32_t i = n - 1; i > 0; i--)
+                std::swap(order[i], order[rnd.below(i + 1)]);
+        int acc = order[0];
+        for (uint32_t i = 1; i < n; i++) {
+            int z = cnf.newVar();
+            addXor(cnf, z, acc, order[i]);
+            acc = z;
+        }
+        // the first chain asserts odd parity, the second one asserts the same (SAT) or the opposite
+        cnf.add({ chain == 0 || sat ? acc : -acc });
+    }
+}
+
+static void genColoring(CNF& cnf, uint32_t n, double degree, uint32_t k, uint64_t seed) {
+    if (n < 2 || k < 1) throw std::runtime_error("N must be >= 2 and K must be >= 1");
+    Random rnd(seed);
+    // x(v, c): vertex v has colour c
+    auto x = [k](uint32_t v, uint32_t c) { return (int)(v * k + c + 1); };
+    cnf.setNumVars(n * k);
+    for (uint32_t v = 0; v < n; v++) {
+        vector<int> c;
+        for (uint32_t i = 0; i < k; i++) c.push_back(x(v, i));
+        cnf.add(c);
+        for (uint32_t i = 0; i < k; i++)
+            for (uint32_t j = i + 1; j < k; j++)
+                cnf.add({ -x(v, i), -x(v, j) });
+    }
+    uint64_t m = (uint64_t)std::llround(n * degree / 2);
+    vector<std::pair<uint32_t, uint32_t>> edges;
+    while (edges.size() < m && edges.size() < (uint64_t)n * (n - 1) / 2) {
+        uint32_t u = rnd.below(n), v = rnd.below(n);
+        if (u == v) continue;
+        if (u > v) std::swap(u, v);
+        if (std::find(edges.begin(), edges.end(), std::make_pair(u, v)) != edges.end()) continue;
+        edges.emplace_back(u, v);
+        for (uint32_t i = 0; i < k; i++)
+            cnf.add({ -x(u, i), -x(v, i) });
+    }
+}
+
+static void usage() {
+    fprintf(stderr,
+        "usage: dps-gen-cnf rand K N RATIO SEED\n"
+        "       dps-gen-cnf php N\n"
+        "       dps-gen-cnf parity N SEED sat|unsat\n"
+        "       dps-gen-cnf color N DEG K SEED\n");
+    exit(1);
+}
+
+static uint64_t toInt(const char *s) {
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (*s == '\0' || *end != '\0') throw std::runtime_error(string("invalid integer '") + s + "'");
+    return v;
+}
+
+static double toReal(const char *s) {
+    char *end;
+    double v = strtod(s, &end);
+    if (*s == '\0' || *end != '\0') throw std::runtime_error(string("invalid number '") + s + "'");
+    return v;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) usage();
+    const string family = argv[1];
+    string comment = family;
+    for (int i = 2; i < argc; i++) comment += string(" ") + argv[i];
+    try {
+        CNF cnf;
+        if (family == "rand" && argc == 6)
+            genRandom(cnf, toInt(argv[2]), toInt(argv[3]), toReal(argv[4]), toInt(argv[5]));
+        else if (family == "php" && argc == 3)
+            genPigeonhole(cnf, toInt(argv[2]));
+        else if (family == "parity" && argc == 5 && (string(argv[4]) == "sat" || string(argv[4]) == "unsat"))
+            genParity(cnf, toInt(argv[2]), toInt(argv[3]), string(argv[4]) == "sat");
+        else if (family == "color" && argc == 6)
+            genColoring(cnf, toInt(argv[2]), toReal(argv[3]), toInt(argv[4]), toInt(argv[5]));
+        else
+            usage();
+        cnf.write(stdout, comment);
+    } catch (std::exception& e) {
+        fprintf(stderr, "dps-gen-cnf: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#!/bin/bash
+# Determinism stress test of DPS.
+#
+# Solves the same instance several times while random delays are injected at synchronization
+# points of threads (--sched-noise with a different seed in each run), and checks that the
+# result, the winner thread, the winner period, the conflicts of each thread and the model are
+# identical to those of the run without noise.
+#
+# usage: determinism.sh [options] <dimacs> [-- <DPS options>]
+#   --dps FILE       DPS executable (default: the newest ./Release/DPS-*)
+#   --runs N         # of runs with noise (default: 5)
+#   --noise-us N     maximum length of an injected delay [us] (default: 200)
+#   --out DIR        directory for the logs (default: ./determinism)
+
+set -u
+
+DPS=""
+RUNS=5
+NOISE_US=200
+OUT=determinism
+CNF=""
+
+die() { echo "determinism.sh: $*" >&2; exit 2; }
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --dps)      DPS="$2";      shift 2 ;;
+        --runs)     RUNS="$2";     shift 2 ;;
+        --noise-us) NOISE_US="$2"; shift 2 ;;
+        --out)      OUT="$2";      shift 2 ;;
+        -h|--help)  sed -n '2,/^$/s/^# \{0,1\}//p' "$0"; exit 0 ;;
+        --)         shift; break ;;
+        -*)         die "unknown option '$1'" ;;
+        *)          [ -z "$CNF" ] || die "more than one instance"; CNF="$1"; shift ;;
+    esac
+done
+[ -n "$CNF" ] || die "no instance (see -h)"
+[ -r "$CNF" ] || die "can not read '$CNF'"
+if [ -z "$DPS" ]; then
+    DPS=$(ls -t Release/DPS-* 2>/dev/null | head -n 1)
+    [ -n "$DPS" ] || die "no DPS executable (use --dps)"
+fi
+[ -x "$DPS" ] || die "'$DPS' is not executable"
+mkdir -p "$OUT" || die "can not create '$OUT'"
+
+# prints the outcome of a run that must not depend on the timing of threads
+signature() {
+    awk -F, '
+        $1 != "summary" { next }
+        $3 == "Result"                      { print "result " $5 }
+        $3 == "Winner"                      { print "winner " $5 }
+        $3 == "WinnerPeriod"                { print "winner-period " $5 }
+        $3 == "Conflicts" && $4 != "total"  { print "conflicts-" $4 " " $5 }' "$1.csv"
+    echo "model $(grep '^v' "$1.log" | md5sum | cut -d' ' -f1)"
+}
+
+status=0
+for r in $(seq 0 "$RUNS"); do
+    noise=""
+    [ "$r" -eq 0 ] || noise="--sched-noise $r --sched-noise-us $NOISE_US"
+    "$DPS" "$@" $noise --model --stats-csv "$OUT/run$r.csv" "$CNF" > "$OUT/run$r.log" 2>&1
+    [ -s "$OUT/run$r.csv" ] || { echo "run $r: FAILED (see $OUT/run$r.log)"; exit 2; }
+    signature "$OUT/run$r" > "$OUT/run$r.sig"
+    if grep -q '^result UNKNOWN' "$OUT/run$r.sig"; then
+        echo "run $r: UNKNOWN (runs stopped by limits are not comparable)"
+        exit 2
+    fi
+    if [ "$r" -eq 0 ]; then
+        echo "run 0: $(tr '\n' ' ' < "$OUT/run0.sig")"
+    elif cmp -s "$OUT/run0.sig" "$OUT/run$r.sig"; then
+        echo "run $r: identical"
+    else
+        echo "run $r: DIFFERENT"
+        diff "$OUT/run0.sig" "$OUT/run$r.sig" | sed -n 's/^[<>] /    /p'
+        status=1
+    fi
+done
+exit $status
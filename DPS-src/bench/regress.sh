@@ -0,0 +1,197 @@
+#!/bin/bash
+# End-to-end performance regression harness of DPS.
+#
+# Generates a fixed CNF corpus with dps-gen-cnf, runs DPS over a matrix of base solvers, # of
+# threads, margins and period lengths, and collects the final statistics from --stats-csv. The
+# results are saved as a baseline or compared with one. Since DPS is deterministic, conflict
+# counts must match the baseline exactly, while the throughput (conflicts/s, periods/s), the
+# waiting ratio (WaitingTime / SolvingTime) and the peak memory are compared with tolerances.
+#
+# usage: regress.sh [options]
+#   --dps FILE        DPS executable (default: the newest ./Release/DPS-*)
+#   --gen FILE        dps-gen-cnf executable (default: next to the DPS executable)
+#   --out DIR         working directory for the corpus and the logs (default: ./regress)
+#   --quick           small corpus and matrix (for checking before commits)
+#   --repeat N        run each configuration N times and check that conflicts agree (default: 1)
+#   --save FILE       save the results as a baseline
+#   --baseline FILE   compare the results with a baseline (exit status 1 on regressions)
+#
+# The matrix and the tolerances can be changed by environment variables:
+#   SOLVERS, THREADS, MARGINS, PERIODS, TIME_LIM (seconds per run),
+#   TPUT_TOL (relative, 0.10), WAIT_TOL (absolute, 0.05), MEM_TOL (relative, 0.10),
+#   MIN_TIME (throughputs of shorter runs are not compared, 1.0 seconds)
+
+set -u
+
+DPS=""
+GEN=""
+OUT=regress
+QUICK=0
+REPEAT=1
+SAVE=""
+BASELINE=""
+
+die() { echo "regress.sh: $*" >&2; exit 2; }
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --dps)      DPS="$2";      shift 2 ;;
+        --gen)      GEN="$2";      shift 2 ;;
+        --out)      OUT="$2";      shift 2 ;;
+        --quick)    QUICK=1;       shift ;;
+        --repeat)   REPEAT="$2";   shift 2 ;;
+        --save)     SAVE="$2";     shift 2 ;;
+        --baseline) BASELINE="$2"; shift 2 ;;
+        -h|--help)  sed -n '2,/^$/s/^# \{0,1\}//p' "$0"; exit 0 ;;
+        *)          die "unknown option '$1'" ;;
+    esac
+done
+
+if [ -z "$DPS" ]; then
+    DPS=$(ls -t Release/DPS-* 2>/dev/null | head -n 1)
+    [ -n "$DPS" ] || die "no DPS executable (use --dps)"
+fi
+[ -x "$DPS" ] || die "'$DPS' is not executable"
+[ -n "$GEN" ] || GEN="$(dirname "$DPS")/dps-gen-cnf"
+[ -x "$GEN" ] || die "'$GEN' is not executable (configure with -DDPS_BUILD_BENCH=ON or use --gen)"
+[ -z "$BASELINE" ] || [ -r "$BASELINE" ] || die "can not read baseline '$BASELINE'"
+
+if [ $QUICK -eq 1 ]; then
+    SOLVERS=${SOLVERS:-"kissat minisat"}
+    THREADS=${THREADS:-"2"}
+    MARGINS=${MARGINS:-"20"}
+    PERIODS=${PERIODS:-"2000000"}
+else
+    SOLVERS=${SOLVERS:-"kissat glucose minisat mcomsps"}
+    THREADS=${THREADS:-"2 4 8"}
+    MARGINS=${MARGINS:-"0 20"}
+    PERIODS=${PERIODS:-"500000 2000000"}
+fi
+TIME_LIM=${TIME_LIM:-300}
+TPUT_TOL=${TPUT_TOL:-0.10}
+WAIT_TOL=${WAIT_TOL:-0.05}
+MEM_TOL=${MEM_TOL:-0.10}
+MIN_TIME=${MIN_TIME:-1.0}
+
+# corpus: name and arguments of dps-gen-cnf (random k-SAT near the threshold, pigeonhole,
+# XOR chains and graph colouring at several sizes)
+CORPUS=(
+    "rand3-200      rand 3 200 4.26 1"
+    "php-8          php 8"
+    "parity-24      parity 24 1 unsat"
+    "color3-200     color 200 4.7 3 2"
+)
+if [ $QUICK -eq 0 ]; then
+    CORPUS+=(
+        "rand3-250  rand 3 250 4.26 2"
+        "rand4-120  rand 4 120 9.9 1"
+        "php-9      php 9"
+        "parity-30  parity 30 2 unsat"
+        "color4-100 color 100 8.4 4 1"
+    )
+fi
+
+mkdir -p "$OUT/cnf" "$OUT/log" || die "can not create '$OUT'"
+for entry in "${CORPUS[@]}"; do
+    set -- $entry
+    name=$1; shift
+    "$GEN" "$@" > "$OUT/cnf/$name.cnf" || die "failed to generate $name"
+done
+
+# prints "result conflicts real-time conflicts/s periods/s waiting-ratio peak-memory" of a run
+summarize() {
+    awk -F, -v nthreads="$2" '
+        $1 != "summary" { next }
+        $3 == "Result"                                 { result = $5 }
+        $3 == "Conflicts"   && $4 == "total"           { conflicts = $5 }
+        $3 == "Periods"     && $4 == "total"           { periods = $5 }
+        $3 == "WaitingTime" && $4 == "total"           { waiting = $5 }
+        $3 == "SolvingTime" && $4 == "total"           { solving = $5 }
+        $3 == "RealTime"                               { realtime = $5 }
+        $3 == "PeakMemory"                             { peak = $5 }
+        END {
+            if (result == "") exit 1
+            t = realtime > 0 ? realtime : 1e-9
+            cps = conflicts / t
+            pps = periods / nthreads / t
+            wait = solving > 0 ? waiting / solving : 0
+            printf "%s %d %.3f %.0f %.1f %.4f %.1f\n", result, conflicts, realtime, cps, pps, wait, peak
+        }' "$1"
+}
+
+RESULTS="$OUT/results.txt"
+FORMAT="%-12s %-8s %3s %3s %8s %-7s %10s %9s %10s %9s %7s %8s\n"
+printf "$FORMAT" "#instance" solver thn mrg period result conflicts time confs/s prds/s wait peak > "$RESULTS"
+status=0
+for entry in "${CORPUS[@]}"; do
+    set -- $entry
+    name=$1
+    for solver in $SOLVERS; do
+    for n in $THREADS; do
+    for m in $MARGINS; do
+    for p in $PERIODS; do
+        best=""
+        for r in $(seq 1 "$REPEAT"); do
+            tag="$name.$solver.n$n.m$m.p$p.r$r"
+            "$DPS" -s "$solver" -n "$n" -m "$m" -p "$p" --real-time-lim "$TIME_LIM" \
+                --stats-csv "$OUT/log/$tag.csv" "$OUT/cnf/$name.cnf" > "$OUT/log/$tag.log" 2>&1
+            line=$(summarize "$OUT/log/$tag.csv" "$n") || { echo "FAILED  $tag (see $OUT/log/$tag.log)"; status=1; continue; }
+            set -- $line
+            if [ -z "$best" ]; then
+                best="$line"
+            else
+                set -- $best
+                b_res=$1; b_confs=$2; b_time=$3
+                set -- $line
+                # a run stopped by the time limit is not reproducible
+                if [ "$1" != UNKNOWN ] && [ "$b_res" != UNKNOWN ] && [ "$2" != "$b_confs" ]; then
+                    echo "NONDET  $tag: $2 conflicts (first run: $b_confs)"
+                    status=1
+                fi
+                awk -v a="$3" -v b="$b_time" 'BEGIN { exit !(a < b) }' && best="$line"
+            fi
+        done
+        [ -n "$best" ] || continue
+        set -- $best
+        printf "$FORMAT" "$name" "$solver" "$n" "$m" "$p" "$@" | tee -a "$RESULTS"
+    done
+    done
+    done
+    done
+done
+
+if [ -n "$SAVE" ]; then
+    cp "$RESULTS" "$SAVE" && echo "baseline saved to $SAVE"
+fi
+
+if [ -n "$BASELINE" ]; then
+    awk -v tput_tol="$TPUT_TOL" -v wait_tol="$WAIT_TOL" -v mem_tol="$MEM_TOL" -v min_time="$MIN_TIME" '
+        /^#/ { next }
+        {
+            key = $1 " " $2 " n" $3 " m" $4 " p" $5
+            if (FNR == NR) { base[key] = $0; next }
+            if (!(key in base)) { print "NEW     " key; next }
+            split(base[key], b, " ")
+            checked++
+            if ($6 != b[6] && $6 != "UNKNOWN" && b[6] != "UNKNOWN")
+                { print "RESULT  " key ": " $6 " (baseline " b[6] ")"; bad++ }
+            if ($6 != "UNKNOWN" && b[6] != "UNKNOWN" && $7 != b[7])
+                { print "CONFS   " key ": " $7 " conflicts (baseline " b[7] ")"; bad++ }
+            if ($8 >= min_time && b[8] >= min_time) {
+                if ($9 < b[9] * (1 - tput_tol))
+                    { printf "SLOW    %s: %s conflicts/s (baseline %s, %+.1f%%)\n", key, $9, b[9], 100 * ($9 / b[9] - 1); bad++ }
+                if (b[10] > 0 && $10 < b[10] * (1 - tput_tol))
+                    { printf "SLOW    %s: %s periods/s (baseline %s, %+.1f%%)\n", key, $10, b[10], 100 * ($10 / b[10] - 1); bad++ }
+            }
+            if ($11 > b[11] + wait_tol)
+                { print "WAIT    " key ": waiting ratio " $11 " (baseline " b[11] ")"; bad++ }
+            if ($12 > b[12] * (1 + mem_tol))
+                { print "MEMORY  " key ": peak " $12 " MB (baseline " b[12] " MB)"; bad++ }
+        }
+        END {
+            printf "compared %d runs with the baseline: %d regressions\n", checked, bad
+            exit bad > 0
+        }' "$BASELINE" "$RESULTS" || status=1
+fi
+
+exit $status
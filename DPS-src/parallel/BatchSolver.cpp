@@ -0,0 +1,186 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <cstdio>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "BatchSolver.h"
+#include "../utils/System.h"
+
+using namespace DPS;
+using std::cout;
+using std::endl;
+
+BatchSolver::BatchSolver(const Options& _options) :
+    options(_options)
+,   num_jobs(1)
+,   job_threads(1)
+,   next_file(0)
+,   next_print(0)
+,   num_sat(0)
+,   num_unsat(0)
+,   num_unknown(0)
+,   num_errors(0)
+{
+    if (options.getShowModel() || !options.getTraceFile().empty() || options.hasStatsSink() || !options.getLiveShm().empty())
+        throw std::runtime_error("the batch mode does not support --model, --trace, --stats-json, --stats-csv and --live-shm");
+    // the scheduling noise is global to the process, so it would be injected into all jobs at once
+    if (options.getSchedNoise())
+        throw std::runtime_error("the batch mode does not support --sched-noise");
+    if (options.getInputFile().empty())
+        throw std::runtime_error("no list of instances is given for the batch mode");
+    files = listInstances(options.getInputFile());
+    if (files.empty())
+        throw std::runtime_error("no instances in '" + options.getInputFile() + "'");
+    results.resize(files.size(), Result{ false, false, UNKNOWN, "" });
+
+    // the threads and the memory limit are divided among the jobs (the share of the memory limit is
+    // checked against the estimators of the solvers of each job, see DetParallelSolver::solve)
+    uint32_t num_threads = options.getNumThreads();
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+    num_jobs    = std::max(1u, std::min<uint32_t>(options.getBatchJobs(), files.size()));
+    job_threads = std::max(1u, num_threads / num_jobs);
+
+    options.quiet();
+    options.setBatch(false);
+    options.setNumThreads(job_threads);
+    if (options.getDecodeThreads() == 0)
+        options.setDecodeThreads(job_threads);
+    if (options.getMemUseLim() > 0)
+        options.setMemUseLim(options.getMemUseLim() / num_jobs);
+    options.setMemLimPerJob(true);
+}
+
+// Returns the instances in 'path', which are the regular files of a directory (in the order of
+// names, except hidden ones) or the lines of a file (except empty lines and comments by '#').
+vector<string> BatchSolver::listInstances(const string& path) {
+    vector<string> files;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        throw std::runtime_error("could not open '" + path + "'");
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path.c_str());
+        if (dir == nullptr)
+            throw std::runtime_error("could not open the directory '" + path + "'");
+        while (struct dirent *e = readdir(dir)) {
+            string name = e->d_name;
+            string file = path + (path.back() == '/' ? "" : "/") + name;
+            if (name[0] != '.' && stat(file.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+                files.push_back(file);
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("could not open '" + path + "'");
+    string line;
+    while (std::getline(in, line)) {
+        size_t b = line.find_first_not_of(" \t\r");
+        size_t e = line.find_last_not_of(" \t\r");
+        if (b == string::npos || line[b] == '#') continue;
+        files.push_back(line.substr(b, e - b + 1));
+    }
+    return files;
+}
+
+int BatchSolver::run() {
+    double start = realTime();
+    cout << "c Batch: " << files.size() << " instances by " << num_jobs << " jobs of " << job_threads << " threads" << endl;
+
+    vector<std::thread> jobs;
+    for (uint32_t i = 1; i < num_jobs; i++)
+        jobs.emplace_back(&BatchSolver::runJob, this);
+    runJob();
+    for (std::thread& t : jobs)
+        t.join();
+
+    printf("c Batch: %llu SAT, %llu UNSAT, %llu UNKNOWN, %llu errors (%.2f s)\n",
+        (unsigned long long)num_sat, (unsigned long long)num_unsat, (unsigned long long)num_unknown,
+        (unsigned long long)num_errors, realTime() - start);
+    fflush(stdout);
+    return num_errors > 0 ? 1 : 0;
+}
+
+// A job takes the next instance until all instances are taken.
+void BatchSolver::runJob() {
+    DetParallelSolver dps;
+    dps.setReuseThreads(true);
+    while (true) {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (next_file == files.size()) break;
+            index = next_file++;
+        }
+        report(index, solveInstance(dps, index));
+    }
+}
+
+BatchSolver::Result BatchSolver::solveInstance(DetParallelSolver& dps, size_t index) {
+    const string& file = files[index];
+    Result r{ true, false, UNKNOWN, "b " + std::to_string(index) + " " };
+    try {
+        Options o = options;
+        o.setInputFile(file);
+        dps.setOptions(o);
+        dps.clearFormula();
+        r.status = dps.solve();
+
+        r.line += r.status == SAT ? "SAT" : r.status == UNSAT ? "UNSAT" : "UNKNOWN";
+        r.line += resultFields(dps, (SATResult)r.status);
+        if (r.status == SAT && options.getVerifyModel()) {
+            r.error = !dps.verifyModel(dps.getModel());
+            r.line += r.error ? " verified=NO" : " verified=yes";
+        }
+        r.line += " " + file;
+    } catch (std::exception& e) {
+        r.error = true;
+        r.line += "ERROR " + file + ": " + e.what();
+    }
+    return r;
+}
+
+// Returns the fields of a result line after the result of the last call of dps.solve() (also used
+// by the daemon mode).
+string BatchSolver::resultFields(DetParallelSolver& dps, SATResult status) {
+    StatsRecord stats;
+    dps.collectStats(stats);
+    auto get = [&stats](const char *name) {
+        StatsRecord::Value v;
+        return stats.get(name, v) ? v : StatsRecord::Value();
+    };
+    char buf[256];
+    snprintf(buf, sizeof(buf), " time=%.3f vars=%lld clauses=%lld conflicts=%lld",
+        get("RealTime").d, (long long)get("Variables").i, (long long)get("Clauses").i, (long long)get("Conflicts_total").i);
+    string fields = buf;
+    if (status != UNKNOWN) {
+        snprintf(buf, sizeof(buf), " winner=%lld period=%lld", (long long)get("Winner").i, (long long)get("WinnerPeriod").i);
+        fields += buf;
+    }
+    return fields;
+}
+
+// Records the result of the instance, and prints the result lines that are ready in the order of
+// the instances.
+void BatchSolver::report(size_t index, const Result& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    results[index] = result;
+    while (next_print < results.size() && results[next_print].done) {
+        Result& r = results[next_print++];
+        if      (r.error)           num_errors++;
+        else if (r.status == SAT)   num_sat++;
+        else if (r.status == UNSAT) num_unsat++;
+        else                        num_unknown++;
+        cout << r.line << endl;
+        string().swap(r.line);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef _DPS_BATCH_SOLVER_H_
+#define _DPS_BATCH_SOLVER_H_
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "Options.h"
+#include "DetParallelSolver.h"
+
+namespace DPS {
+
+using std::string;
+using std::vector;
+
+// Solves many instances in one process (the 'batch' option). The instances are taken in order by
+// 'batch-jobs' concurrent jobs, and the threads are divided among the jobs. Each job solves its
+// instances by one DetParallelSolver of which worker threads (and their allocator arenas) are
+// kept across instances. A result line is printed per instance in the order of the list:
+//   b <index> <SAT|UNSAT|UNKNOWN> time=<s> vars=<n> clauses=<n> conflicts=<n> [winner=<thread> period=<n>] <file>
+//   b <index> ERROR <file>: <message>
+class BatchSolver {
+private:
+    struct Result {
+        bool   done;
+        bool   error;               // the instance could not be solved or the model is wrong
+        int    status;              // SATResult
+        string line;
+    };
+
+    Options         options;        // options of each job
+    vector<string>  files;          // instances
+    uint32_t        num_jobs;
+    uint32_t        job_threads;    // # of threads of each job
+
+    std::mutex      mutex;
+    size_t          next_file;      // index of the next instance to be solved
+    size_t          next_print;     // index of the next result line to be printed
+    vector<Result>  results;        // results of instances (those printed are released)
+    uint64_t        num_sat;
+    uint64_t        num_unsat;
+    uint64_t        num_unknown;
+    uint64_t        num_errors;
+
+    static vector<string> listInstances(const string& path);
+    void   runJob();
+    Result solveInstance(DetParallelSolver& dps, size_t index);
+    void   report(size_t index, const Result& result);
+
+public:
+    // throws std::runtime_error if the instances can not be listed
+    BatchSolver(const Options& options);
+
+    // returns 0 if all instances are solved without errors, otherwise 1
+    int run();
+
+    // " time=<s> vars=<n> clauses=<n> conflicts=<n> [winner=<thread> period=<n>]" of the last call of dps.solve()
+    static string resultFields(DetParallelSolver& dps, SATResult status);
+};
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include <iostream>
+#include <cstdio>
+#include <thread>
+#include <inttypes.h>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "CubeSolver.h"
+#include "../utils/System.h"
+
+using namespace DPS;
+
+CubeSolver::CubeSolver(DetParallelSolver& _dps) :
+    dps(_dps)
+,   options(_dps.getOptions())
+,   lookahead(_dps.getFormula())
+,   num_rounds(0)
+,   num_refuted(0)
+,   num_dropped(0)
+,   num_splits(0)
+{
+}
+
+// Adds the clause that refutes the cube 'lits'.
+void CubeSolver::addRefutation(const vector<int>& lits) {
+    vector<int> clause;
+    for (int lit : lits)
+        clause.push_back(-lit);
+    dps.addClause(clause);
+}
+
+// Splits 'cube' into two cubes put at the front (or the back) of the queue. Returns false if the
+// cube can not be split, and a cube refuted by the lookahead is dropped.
+bool CubeSolver::split(vector<int> cube, bool front) {
+    vector<int> refined = cube;
+    int var;
+    switch (lookahead.split(refined, var)) {
+        case Lookahead::REFUTED:
+            addRefutation(cube);
+            num_dropped++;
+            return true;
+        case Lookahead::NO_SPLIT:
+            return false;
+        case Lookahead::SPLIT:
+            break;
+    }
+    vector<int> neg = refined;
+    refined.push_back(var);
+    neg.push_back(-var);
+    if (front) {
+        cubes.push_front(neg);
+        cubes.push_front(refined);
+    } else {
+        cubes.push_back(refined);
+        cubes.push_back(neg);
+    }
+    num_splits++;
+    return true;
+}
+
+// Splits the cubes from the front of the queue until the queue has 'num_cubes' cubes or no cube
+// can be split.
+void CubeSolver::refine(size_t num_cubes) {
+    size_t unsplittable = 0;
+    while (!cubes.empty() && cubes.size() < num_cubes && unsplittable < cubes.size()) {
+        vector<int> cube = cubes.front();
+        cubes.pop_front();
+        if (!split(cube, false)) {
+            cubes.push_back(cube);
+            unsplittable++;
+        }
+    }
+}
+
+SATResult CubeSolver::solve() {
+    double start = realTime();
+    SATResult result = solveRounds(start);
+
+    // the statistics of 'dps' are those of the last round except the cumulative counters of the
+    // kept solvers, so the time and the cube counters are given over all rounds
+    double   time    = realTime() - start;
+    uint64_t rounds  = num_rounds, refuted = num_refuted, dropped = num_dropped, splits = num_splits;
+    dps.setStatsCallback([=](StatsRecord& stats) {
+        stats.section("Cube stats");
+        stats.set("CubeRounds",              rounds);
+        stats.set("CubesRefuted",            refuted);
+        stats.set("CubesRefutedByLookahead", dropped);
+        stats.set("CubeSplits",              splits);
+        stats.section("System stats", 1);
+        stats.set("RealTime",                time);
+    });
+    return result;
+}
+
+SATResult CubeSolver::solveRounds(double start) {
+    dps.setIncremental(true);
+    dps.loadInputFile();
+
+    uint32_t num_threads = options.getNumThreads();
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+    cubes.push_back(vector<int>());
+    refine((size_t)num_threads * options.getCubeFactor());
+    if (options.verbose())
+        printf("c Cubes: %zu initial cubes (%.2f s)\n", cubes.size(), realTime() - start);
+    fflush(stdout);
+
+    double time_lim = options.getRealTimeLim();
+    while (!cubes.empty()) {
+        double remaining = time_lim > 0 ? time_lim - (realTime() - start) : 0;
+        if (time_lim > 0 && remaining <= 0)
+            return UNKNOWN;
+
+        // the threads beyond the cubes solve the clauses without assumptions
+        vector<vector<int>> round;
+        while (round.size() < num_threads && !cubes.empty()) {
+            round.push_back(cubes.front());
+            cubes.pop_front();
+        }
+        SATResult result = dps.solveCubes(round, SolveLimits(remaining, options.getCubeConfs()));
+        num_rounds++;
+        if (result != UNKNOWN)
+            return result;
+        if (time_lim > 0 && realTime() - start >= time_lim)
+            return UNKNOWN;
+
+        // the cubes not refuted are put back to the front in the same order (the threads beyond
+        // the # of threads adjusted by the memory limit did not take their cubes)
+        uint32_t solved = std::min<size_t>(round.size(), dps.getNumThreads());
+        uint64_t refuted = 0, hard = 0;
+        for (size_t i = round.size(); i > 0; i--) {
+            vector<int> failed;
+            if (i - 1 >= solved)
+                cubes.push_front(round[i - 1]);
+            else if (dps.getCubeResult(i - 1, failed) == UNSAT) {
+                addRefutation(failed);
+                refuted++;
+            }
+            else {
+                if (!split(round[i - 1], true))
+                    cubes.push_front(round[i - 1]);
+                hard++;
+            }
+        }
+        num_refuted += refuted;
+        num_threads = dps.getNumThreads();
+        refine(num_threads);
+        if (options.verbose())
+            printf("c Cube round %" PRIu64 ": %zu cubes, %" PRIu64 " refuted, %" PRIu64 " hard, %zu queued (%.2f s)\n",
+                num_rounds, round.size(), refuted, hard, cubes.size(), realTime() - start);
+        fflush(stdout);
+    }
+
+    // all cubes are refuted, and the clauses are refuted without assumptions
+    double remaining = time_lim > 0 ? time_lim - (realTime() - start) : 0;
+    if (time_lim > 0 && remaining <= 0)
+        return UNKNOWN;
+    return dps.solve(SolveLimits(remaining));
+}
@@ -0,0 +1,52 @@
+#ifndef _DPS_CUBE_SOLVER_H_
+#define _DPS_CUBE_SOLVER_H_
+
+#include <vector>
+#include <deque>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "DetParallelSolver.h"
+#include "../sat/Lookahead.h"
+
+namespace DPS {
+
+using std::vector;
+
+// Cube-and-conquer mode (the 'cube' option). The clauses are split into cubes by Lookahead, and
+// the cubes are solved in rounds by DetParallelSolver::solveCubes: thread i takes the i-th cube of
+// the queue as assumptions and solves it within 'cube-confs' conflicts, while the threads exchange
+// learnt clauses as usual. The base solvers take assumptions as decisions, so their learnt clauses
+// do not depend on the cubes, and they are shared and kept across rounds (incremental mode). A
+// refuted cube adds the negation of the assumptions in its final conflict to the clauses (which
+// may prune other cubes), and a cube not solved in the round is split into two cubes at the front
+// of the queue. The queue is changed only between rounds from the results of threads, so the whole
+// run is deterministic. When all cubes are refuted, the clauses are solved without assumptions to
+// conclude UNSAT.
+class CubeSolver {
+private:
+    DetParallelSolver&  dps;
+    Options             options;
+    Lookahead           lookahead;
+    std::deque<vector<int>> cubes;  // queue of cubes to be solved
+
+    uint64_t num_rounds;
+    uint64_t num_refuted;           // cubes refuted by threads
+    uint64_t num_dropped;           // cubes refuted by the lookahead
+    uint64_t num_splits;
+
+    SATResult solveRounds(double start);
+    bool   split(vector<int> cube, bool front);
+    void   refine(size_t num_cubes);
+    void   addRefutation(const vector<int>& lits);
+
+public:
+    CubeSolver(DetParallelSolver& dps);
+
+    // solves the clauses of 'dps' (the result and the model are given by 'dps', and the statistics
+    // of 'dps' are completed by the totals over all rounds)
+    SATResult solve();
+};
+
+}
+
+#endif
@@ -5,84 +5,250 @@
 #include <ctime>
 #include <vector>
 #include <thread>
+#include <future>
 #include <stdio.h>
 #include <unistd.h>
 #include <inttypes.h>
 
 // Include files should be specified relatively to avoid confusion with same named files.
 #include "DetParallelSolver.h"
+#include "MemoryPlanner.h"
 #include "../solvers/SolverFactory.h"
 #include "../sat/Instance.h"
 #include "../utils/System.h"
+#include "../utils/SchedNoise.h"
 
 using namespace DPS;
 using std::cout;
 using std::endl;
 
+static const uint64_t MAX_VAR = (1u << 28) - 1;    // the largest variable accepted by all base solvers (Kissat)
+
 DetParallelSolver::DetParallelSolver() :
     sharer(NULL)
+,   portfolio(NULL)
 ,   num_threads(0)    
+,   num_loaded_clauses(0)
+,   incremental(false)
 ,   start_real_time(0.0)
+,   used_mem_after_loading(0.0)
 ,   num_print_stats(0)
+,   stop_requested(false)
+,   reuse_threads(false)
+,   pool_gen(0)
+,   pool_running(0)
+,   pool_shutdown(false)
 {
     pthread_mutex_init(&mfinished, NULL); //PTHREAD_MUTEX_INITIALIZER;
     pthread_cond_init(&cfinished, NULL);
+    pthread_mutex_init(&pool_mutex, NULL);
+    pthread_cond_init(&pool_job, NULL);
+    pthread_cond_init(&pool_done, NULL);
 }
 
-static void *localLaunch(void *arg) {
-    AbstDetSeqSolver *s = (AbstDetSeqSolver *) arg;
-    
+static void runSolver(AbstDetSeqSolver *s) {
+    // periods are measured by the counter of this thread, which may be reused from the last solve
+    num_mem_accesses = 0;
     s->getSharer()->incNumLiveThreads();
+    if (s->getOptions().getPerf()) {
+        std::string error;
+        if (!s->openPerfCounters(error) && s->getThreadID() == 0 && s->getOptions().verbose())
+            printf("c NOTE: hardware counters are not available (%s)\n", error.c_str());
+    }
     s->solve();
+    s->closePerfCounters();
+    s->publishLive(LIVE_FINISHED);
     s->getSharer()->decNumLiveThreads();
+}
 
+static void *localLaunch(void *arg) {
+    runSolver((AbstDetSeqSolver *) arg);
     pthread_exit(NULL);
 }
 
+// A worker runs the task of each job with its index until the shutdown. Workers of which index
+// is not less than the # of threads of a job skip it.
+void *DetParallelSolver::workerLoop(void *arg) {
+    Worker *w = (Worker *) arg;
+    DetParallelSolver *dps = w->owner;
+    uint64_t gen = 0;
+    pthread_mutex_lock(&dps->pool_mutex);
+    while (true) {
+        while (!dps->pool_shutdown && dps->pool_gen == gen)
+            pthread_cond_wait(&dps->pool_job, &dps->pool_mutex);
+        if (dps->pool_shutdown) break;
+        gen = dps->pool_gen;
+        if (w->index >= dps->num_threads) continue;
+        std::function<void(uint32_t)> task = dps->pool_task;
+        pthread_mutex_unlock(&dps->pool_mutex);
+        task(w->index);
+        pthread_mutex_lock(&dps->pool_mutex);
+        if (--dps->pool_running == 0)
+            pthread_cond_signal(&dps->pool_done);
+    }
+    pthread_mutex_unlock(&dps->pool_mutex);
+    return NULL;
+}
+
+// Starts a job calling 'task' with the index of each worker on the first # of threads workers
+// (created if not enough).
+void DetParallelSolver::runJob(std::function<void(uint32_t)> task) {
+    pthread_mutex_lock(&pool_mutex);
+    while (workers.size() < num_threads) {
+        Worker *w = new Worker{ this, (uint32_t)workers.size(), pthread_t() };
+        if (pthread_create(&w->thread, NULL, &workerLoop, w) != 0) {
+            delete w;
+            pthread_mutex_unlock(&pool_mutex);
+            throw std::runtime_error("could not create a worker thread");
+        }
+        workers.push_back(w);
+    }
+    pool_task    = task;
+    pool_running = num_threads;
+    pool_gen++;
+    pthread_cond_broadcast(&pool_job);
+    pthread_mutex_unlock(&pool_mutex);
+}
+
+void DetParallelSolver::waitJob() {
+    pthread_mutex_lock(&pool_mutex);
+    while (pool_running > 0)
+        pthread_cond_wait(&pool_done, &pool_mutex);
+    pthread_mutex_unlock(&pool_mutex);
+}
+
+void DetParallelSolver::stopWorkers() {
+    pthread_mutex_lock(&pool_mutex);
+    pool_shutdown = true;
+    pthread_cond_broadcast(&pool_job);
+    pthread_mutex_unlock(&pool_mutex);
+    for (Worker *w : workers) {
+        pthread_join(w->thread, NULL);
+        delete w;
+    }
+    workers.clear();
+}
+
 DetParallelSolver::~DetParallelSolver() {
+    stopWorkers();
+    releaseSolvers();
+}
+
+void DetParallelSolver::releaseSolvers() {
     for (auto solver : solvers)
         delete solver;
+    solvers.clear();
     if (sharer) 
         delete sharer;
+    sharer = NULL;
+    if (portfolio)
+        delete portfolio;
+    portfolio = NULL;
 }
 
-SATResult DetParallelSolver::solve() {
-    start_real_time = realTime();
-    
-    // load input formula
-    string input_file = options.getInputFile();
-    if (input_file.size() > 0) {
-        double start = realTime();        
+// Rejects a formula that some base solvers cannot hold (they would abort the process).
+void DetParallelSolver::checkNumVars() {
+    if (input_formula.getNumVars() <= MAX_VAR) return;
+    releaseSolvers();
+    throw std::runtime_error("variable " + std::to_string(input_formula.getNumVars()) + " exceeds the maximum " + std::to_string(MAX_VAR));
+}
 
-        input_formula = Instance::loadFormula(input_file);        
-        used_mem_after_loading = usedMemory();
+void DetParallelSolver::setOptions(const vector<string>& args) {
+    vector<const char*> argv(1, "DPS");
+    for (const string& a : args)
+        argv.push_back(a.c_str());
+    options.parseOptions(argv.size(), argv.data());
+    // the options are given to new solvers
+    releaseSolvers();
+}
 
-        if (options.verbose()) {
-            printf("c Loading '%s' (%.2f s)\n", input_file.c_str(), realTime() - start);
-            cout << "c" << endl;
-            if (options.verbose() >= 2) {
-                cout << "c [Input formula]" << endl;
-                cout << "c  num variables    = " << input_formula.getNumVars() << endl;
-                cout << "c  num clauses      = " << input_formula.getNumClauses() << endl;
-                cout << "c  total literlas   = " << input_formula.getTotalLiterals() << endl;
-                cout << "c  curr used memory = " << used_mem_after_loading << " MB" << endl;
-                cout << "c" << endl;
-            }
+SATResult DetParallelSolver::solve(const vector<int>& assumptions, const vector<vector<int>>* cubes, const SolveLimits& limits) {
+    start_real_time = realTime();
+
+    // the formula is solved from scratch by new solvers unless those of the last call are kept
+    bool restart = incremental && solvers.size() > 0;
+    if (!restart) {
+        releaseSolvers();
+        num_loaded_clauses = 0;
+    }
+    
+    // load input formula in background (decompression and parsing are overlapped with the
+    // construction of solvers)
+    std::future<Instance> loading;
+    double loading_start = realTime();
+    if (needsLoading()) {
+        loading = startLoading();
+        // the adjustment of # of threads requires the input formula
+        if (options.getAdjustThreads() > 0 && options.getMemUseLim() > 0) {
+            waitLoading(loading, loading_start);
+            checkNumVars();
         }
     }
     
     // generate solver objects
-    if (solvers.size() == 0) 
-        generateAllSolvers();
+    // a warm-up of the memory planner may solve the clauses, which is kept unless the result
+    // depends on the assumptions or the solvers are kept for the next call
+    bool presolved = false;
+    if (restart)
+        restartSolvers();
+    else
+        presolved = generateAllSolvers(!incremental && assumptions.empty() && cubes == nullptr);
     assert(solvers.size() > 0);
+    sharer->setCubeMode(cubes != nullptr);
+    for (auto solver : solvers) {
+        if ((incremental || assumptions.size() > 0 || cubes) && !solver->supportsIncremental()) {
+            string name = portfolio->getSlot(solver->getThreadID()).name;
+            releaseSolvers();
+            throw std::runtime_error(name + " does not support incremental solving and assumptions");
+        }
+        uint32_t thn = solver->getThreadID();
+        if (cubes == nullptr)
+            solver->setAssumptions(assumptions);
+        else
+            solver->setAssumptions(thn < cubes->size() ? (*cubes)[thn] : vector<int>());
+        // the conflict limit is relative to the conflicts of the last calls
+        if (limits.real_time > 0) solver->setRealTimeLim(limits.real_time);
+        solver->setConflictLim(limits.conflicts > 0 ? solver->getNumConflicts() + limits.conflicts : 0);
+    }
+
+    if (loading.valid())
+        waitLoading(loading, loading_start);
+    checkNumVars();
 
-    if (options.verbose() >= 2) 
+    // the options and the portfolio are printed only by the first call of the incremental mode
+    if (options.verbose() >= 2 && !restart) {
         options.printOptions();    
+        portfolio->printPortfolio();
+    }
+
+    // set input formula to each solver (only the clauses added after the last call to the kept solvers)
+    const Instance *formula = &input_formula;
+    if (restart) {
+        added_formula = Instance();
+        for (uint64_t i = num_loaded_clauses; i < input_formula.getNumClauses(); i++)
+            added_formula.addClause(input_formula[i].begin(), input_formula[i].size());
+        formula = &added_formula;
+    }
+    num_loaded_clauses = input_formula.getNumClauses();
+    // the memory limit of a job sharing the process with other jobs (batch and daemon modes) is
+    // divided among the threads and checked against the estimators of the solvers, since the RSS
+    // of the process includes the other jobs
+    uint64_t footprint_lim = 0;
+    if (options.getMemLimPerJob() && options.getMemUseLim() > 0)
+        footprint_lim = MemoryPlanner::threadMemLimit(options.getMemUseLim(), input_formula, num_threads);
+    for (auto solver : solvers) {
+        solver->setInputFormula(formula);    // TODO: want to remove input_formula after all solver start to solve.
+        solver->setFootprintLim(footprint_lim);
+    }
 
-    if (input_file.size() > 0) {
-        // set input formula to each solver    
+    // live counters for external tools
+    if (!options.getLiveShm().empty()) {
+        live_stats.close();     // opened by the last solve
+        live_stats.open(options.getLiveShm(), num_threads);
         for (auto solver : solvers)
-            solver->setInputFormula(&input_formula);    // TODO: want to remove input_formula after all solver start to solve.
+            solver->setLiveSlot(live_stats.getSlot(solver->getThreadID()));
+        if (options.verbose())
+            cout << "c Live counters are published in shared memory '" << options.getLiveShm() << "'" << endl;
     }
 
     // Initialize and set thread detached attribute 
@@ -90,13 +256,18 @@ SATResult DetParallelSolver::solve() {
     pthread_attr_init(&thAttr);
     pthread_attr_setdetachstate(&thAttr, PTHREAD_CREATE_JOINABLE);
 
-    for(uint32_t i=0; i < num_threads; i++) {
-        pthread_t *pt = (pthread_t *) malloc(sizeof(pthread_t));
-        threads.push_back(pt);
-        pthread_create(threads[i], &thAttr , &localLaunch, solvers[i]);
-    }
+    if (presolved)
+        ;   // the result is given by the solver taken over from the memory planner
+    else if (reuse_threads)
+        runJob([this](uint32_t i) { runSolver(solvers[i]); });
+    else
+        for(uint32_t i=0; i < num_threads; i++) {
+            pthread_t *pt = (pthread_t *) malloc(sizeof(pthread_t));
+            threads.push_back(pt);
+            pthread_create(threads[i], &thAttr , &localLaunch, solvers[i]);
+        }
 
-    if (options.verbose())
+    if (options.verbose() && !restart)
         cout << "c Launched " << num_threads << " solvers" << endl;
 
     while (true) {
@@ -110,57 +281,153 @@ SATResult DetParallelSolver::solve() {
         if (pthread_cond_timedwait(&cfinished, &mfinished, &to) != ETIMEDOUT)
             break;
         
-        if (verbose())
+        if (verbose() || options.hasStatsSink() || progress_callback)
             printStats();   
     }
 
-    for (uint32_t i=0; i < num_threads; i++) { // Wait for all threads to finish
+    if (reuse_threads)
+        waitJob();
+    for (uint32_t i=0; i < threads.size(); i++) { // Wait for all threads to finish
         pthread_join(*threads[i], NULL);
         free(threads[i]);       
     }
+    threads.clear();
 
-    printResult();
+    if (!options.getTraceFile().empty())
+        writeTrace(options.getTraceFile());
 
     return getResult();
 }
 
-void DetParallelSolver::generateAllSolvers() {   
-    // use # of (logical) CPUs if unspecified
+// Writes the timelines of all solver threads.
+void DetParallelSolver::writeTrace(const string& file) {
+    std::vector<const Tracer*> tracers;
+    std::vector<string>        names;
+    for (auto solver : solvers) {
+        tracers.push_back(&solver->getTracer());
+        names.push_back("T" + std::to_string(solver->getThreadID()) + " " + portfolio->getSlot(solver->getThreadID()).name);
+    }
+    Tracer::writeChromeTrace(file, tracers, names);
+    if (options.verbose())
+        cout << "c Wrote the timeline to '" << file << "'" << endl;
+}
+
+std::future<Instance> DetParallelSolver::startLoading() {
+    uint32_t decode_threads = options.getDecodeThreads();
+    if (decode_threads == 0) decode_threads = std::thread::hardware_concurrency();
+    return std::async(std::launch::async, &Instance::loadFormula, options.getInputFile(), decode_threads);
+}
+
+void DetParallelSolver::loadInputFile() {
+    if (!needsLoading()) return;
+    double start = realTime();
+    std::future<Instance> loading = startLoading();
+    waitLoading(loading, start);
+}
+
+void DetParallelSolver::waitLoading(std::future<Instance>& loading, double start) {
+    // clauses given by addClause() follow those of the input file
+    Instance added = std::move(input_formula);
+    input_formula = loading.get();
+    for (ClauseView c : added)
+        input_formula.addClause(c.begin(), c.size());
+    used_mem_after_loading = usedMemory();
+
+    if (options.verbose()) {
+        printf("c Loading '%s' (%.2f s)\n", options.getInputFile().c_str(), realTime() - start);
+        cout << "c" << endl;
+        if (options.verbose() >= 2) {
+            cout << "c [Input formula]" << endl;
+            cout << "c  num variables    = " << input_formula.getNumVars() << endl;
+            cout << "c  num clauses      = " << input_formula.getNumClauses() << endl;
+            cout << "c  total literlas   = " << input_formula.getTotalLiterals() << endl;
+            cout << "c  curr used memory = " << used_mem_after_loading << " MB" << endl;
+            cout << "c" << endl;
+        }
+    }
+    // the formula is kept for the following calls of solve()
+    loaded_file = options.getInputFile();
+}
+
+// Generates the solvers of the portfolio. Returns true if the clauses have been solved by the
+// warm-up of the memory planner (kept only if 'keep_solved'), whose solver is taken over.
+bool DetParallelSolver::generateAllSolvers(bool keep_solved) {   
+    portfolio = new Portfolio(options);
+
+    // the noise of an earlier run in this process is not carried over
+    if (options.getSchedNoise())
+        SchedNoise::enable(options.getSchedNoise(), options.getSchedNoiseUs());
+    else
+        SchedNoise::disable();
+
+    // use # of threads in the portfolio or # of (logical) CPUs if unspecified
     num_threads = options.getNumThreads();
-    if (options.getNumThreads() == 0)
+    if (num_threads == 0)
+        num_threads = portfolio->getSpecNumThreads();
+    if (num_threads == 0)
         num_threads = std::thread::hardware_concurrency();
 
-    // adjust # of threads to avoid consuming all memory
-    uint32_t adjust_threads = options.getAdjustThreads();
-    uint32_t mem_use_lim    = options.getMemUseLim();
-    if (adjust_threads > 0 && mem_use_lim > 0) {
-        if (used_mem_after_loading >= 250) {    // adjust if input instance is somewhat large (heuristics!)
-            // 'used_mem_after_loading * adjust_threads' means the estimated memory size for solving (heuristics!)
-            uint32_t n = mem_use_lim / (used_mem_after_loading * adjust_threads);
-            if (n == 0) n = 1;
-            if (num_threads < n) n = num_threads;
-            if (n != num_threads) {
-                if (options.verbose()) {
-                    cout << "c NOTE: # of threads is adjusted to " << n << " to avoid consuming all memory" << endl;
-                    cout << "c" << endl;
-                }
-                num_threads = n;
+    // adjust # of threads and clause DB limits to avoid consuming all memory
+    uint64_t redundant_lim = 0;
+    if (options.getAdjustThreads() > 0 && options.getMemUseLim() > 0 && input_formula.getNumClauses() > 0) {
+        // the warm-up runs with the scale of memory accesses of the requested portfolio
+        portfolio->assign(num_threads);
+        MemoryPlanner planner(options, *portfolio, input_formula);
+        MemoryPlanner::Plan plan = planner.plan(num_threads, keep_solved);
+        if (options.verbose() >= 2)
+            planner.printPlan(plan);
+        if (plan.solver) {
+            if (options.verbose()) {
+                cout << "c NOTE: the warm-up of the memory plan has solved the clauses" << endl;
+                cout << "c" << endl;
             }
+            num_threads = 1;
+            portfolio->assignOne(plan.slot);
+            sharer  = plan.sharer;
+            solvers = vector<AbstDetSeqSolver*>(1, plan.solver);
+            plan.solver->pmfinished = &mfinished;
+            plan.solver->pcfinished = &cfinished;
+            plan.solver->setStopFlag(&stop_requested);
+            return true;
         }
+        if (plan.num_threads != num_threads) {
+            if (options.verbose()) {
+                cout << "c NOTE: # of threads is adjusted to " << plan.num_threads << " to avoid consuming all memory" << endl;
+                cout << "c" << endl;
+            }
+            num_threads = plan.num_threads;
+        }
+        redundant_lim = plan.redundant_lim;
     }
 
+    portfolio->assign(num_threads);
+
     // generates learnt clause exchanger
     sharer = new Sharer(num_threads, options.getMargin(), options.getMemAccLim(), options.getNonDetMode());
     if (!sharer) throw std::runtime_error("could not allocate memory for Sharer");
     
     // generates sub-solvers
-    solvers = SolverFactory::createSATSolvers(num_threads, sharer, options);
+    solvers = SolverFactory::createSATSolvers(*portfolio, sharer);
 
     // set parameters to each solver
     for (auto solver : solvers) {
         solver->pmfinished = &mfinished;
         solver->pcfinished = &cfinished;
+        solver->setRedundantClauseLimit(redundant_lim);
+        solver->setIncremental(incremental);
+        solver->setStopFlag(&stop_requested);
     }
+    return false;
+}
+
+// Prepares the solvers of the last call for the next one. The periods of all threads restart from
+// 0 on the clause queues of a new sharer, so the next call is as deterministic as the first one.
+void DetParallelSolver::restartSolvers() {
+    delete sharer;
+    sharer = new Sharer(num_threads, options.getMargin(), options.getMemAccLim(), options.getNonDetMode());
+    if (!sharer) throw std::runtime_error("could not allocate memory for Sharer");
+    for (auto solver : solvers)
+        solver->restart(sharer);
 }
 
 // void DetParallelSolver::loadFormula(const string& filename) {
@@ -170,9 +437,8 @@ void DetParallelSolver::generateAllSolvers() {
 
 void DetParallelSolver::printStats() {
     uint32_t verb = options.verbose();
-    if (!verb) return;
     
-    if (num_print_stats % 30 == 0) {
+    if (verb && num_print_stats % 30 == 0) {
         printf("c\n");
         printf("c                                         "); if (verb >= 2) for(size_t i=0; i < solvers.size(); i++) printf("                 thread %2ld                  ", i); printf("\n"); 
         printf("c time           confs/s        wait      "); if (verb >= 2) for(size_t i=0; i < solvers.size(); i++) printf("   periods        redudants        exported "); printf("\n"); 
@@ -195,6 +461,30 @@ void DetParallelSolver::printStats() {
     double wait   = (real_time - cpu_time / solvers.size()) / real_time * 100.0;
     double memory = usedMemory();
 
+    if (options.hasStatsSink() || progress_callback) {
+        StatsRecord progress;
+        progress.set("RealTime",  real_time);
+        progress.set("PeriodLength", mem_acc_lim);
+        progress.set("ConfsPerSec",  confs_per_sec);
+        progress.set("PropsPerSec",  props_per_sec);
+        progress.set("Wait",      wait);
+        progress.set("Memory",    memory);
+        for (size_t i=0; i < solvers.size(); i++) {
+            AbstDetSeqSolver *s = solvers[i];
+            progress.set(i, "State",     s->getSolverState(), false);
+            progress.set(i, "Periods",   s->getCurrPeriod());
+            progress.set(i, "Conflicts", s->getNumConflicts());
+            progress.set(i, "Redundants", s->getNumRedundantClauses());
+            progress.set(i, "Imported",  s->getNumImportedClauses());
+            progress.set(i, "Exported",  s->getNumExportedClauses());
+        }
+        if (options.hasStatsSink())
+            stats_sink.addProgress(progress);
+        if (progress_callback)
+            progress_callback(progress);
+    }
+    if (!verb) return;
+
     printf("c %4d %9" PRIu64 " %5d %8d %2d%% %5d", 
         (int)real_time,
         mem_acc_lim,
@@ -219,182 +509,140 @@ void DetParallelSolver::printStats() {
     fflush(stdout);
 }
 
-void DetParallelSolver::printResult() {
-
-    if (options.verbose() >= 2) {
-        printf("c\n");
-        printf("c [Basic stats]\n");
-        printf("c Threads : %d\n", num_threads);        
-        printf("c Margin : %" PRIu32 "\n", options.getMargin());
-        printf("c Variables : %" PRIu64 "\n", input_formula.getNumVars());
-        printf("c Clauses : %" PRIu64 "\n", input_formula.getNumClauses());
-        printf("c TotalLiterals : %" PRIu64 "\n", input_formula.getTotalLiterals());
-        if (sharer && sharer->getResult() != UNKNOWN)
-            printf("c Winner : %d\n", sharer->getWinner());
-
-        uint64_t total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getNumConflicts();
-            printf("c Conflicts_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c Conflicts_total : %" PRIu64 "\n", total);
-
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getNumDecisions();
-            printf("c Decisions_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c Decisions_total : %" PRIu64 "\n", total);
-
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getNumPropagations();
-            printf("c Propagations_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c Propagations_total : %" PRIu64 "\n", total);
-
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getNumRestarts();
-            printf("c Restarts_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c Restarts_total : %" PRIu64 "\n", total);
-
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getCurrPeriod();
-            printf("c Periods_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c Periods_total : %" PRIu64 "\n", total);
-
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getMemAccLim();
-            printf("c PeriodLength_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c PeriodLength_total : %" PRIu64 "\n", total);
-
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getNumExportedClauses();
-            printf("c Exported_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c Exported_total : %" PRIu64 "\n", total);
-
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getNumImportedClauses();
-            printf("c Imported_%zu : %" PRIu64 "\n", i, c);
-            total += c;
+bool DetParallelSolver::verifyModel(const Model& model) {
+    size_t num_clauses = input_formula.size();
+    if (num_threads <= 1 || num_clauses < num_threads)
+        return model.satisfies(input_formula);
+
+    // each worker checks one range and stops once some worker finds a falsified clause
+    std::atomic<bool> falsified(false);
+    runJob([&](uint32_t i) {
+        const size_t chunk = 1 << 16;
+        const size_t end = num_clauses * (i + 1) / num_threads;
+        for (size_t b = num_clauses * i / num_threads; b < end && !falsified.load(std::memory_order_relaxed); b += chunk) {
+            if (!model.satisfies(input_formula, b, std::min(b + chunk, end))) {
+                falsified = true;
+                return;
+            }
         }
-        printf("c Imported_total : %" PRIu64 "\n", total);
+    });
+    waitJob();
+    return !falsified;
+}
 
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint64_t c = solvers[i]->getNumForcedApplications();
-            printf("c ForcedApplication_%zu : %" PRIu64 "\n", i, c);
-            total += c;
-        }
-        printf("c ForcedApplication_total : %" PRIu64 "\n", total);
+Model DetParallelSolver::getModel() {
+    if (getResult() != SAT)
+        throw std::runtime_error("no model (the last result is not SAT)");
+    return solvers[sharer->getWinner()]->getModel();
+}
 
-        total = 0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            uint32_t c = solvers[i]->getExpLBDthreshold();
-            printf("c ExpLBDThreshold_%zu : %d\n", i, c);
-            total += c;
-        }
-        printf("c ExpLBDThreshold_total : %" PRIu64 "\n", total);
-
-        for (int q = 5; q <= 30; q += 5) {
-            double sum = 0;
-            for (size_t i=0; i < solvers.size(); i++) {
-                double c = solvers[i]->getLBDQuantile((double)q / 100.0);
-                printf("c LBD%02dQuantile_%zu : %.1f\n", q, i, c);
-                sum += c;
-            }
-            printf("c LBD%02dQuantile_total : %.1f\n", q, sum);
-        }
+const vector<int>& DetParallelSolver::getFailedAssumptions() {
+    if (getResult() != UNSAT)
+        throw std::runtime_error("no failed assumptions (the last result is not UNSAT)");
+    return solvers[sharer->getWinner()]->getFailedAssumptions();
+}
 
-        printf("c\n");
-        printf("c [Time stats for parallel proccessing]\n");
+SATResult DetParallelSolver::getCubeResult(uint32_t thn, vector<int>& failed) const {
+    if (thn >= solvers.size())
+        throw std::runtime_error("no thread " + std::to_string(thn));
+    failed = solvers[thn]->getFailedAssumptions();
+    return solvers[thn]->getLastResult();
+}
 
-        double total_time = 0.0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            double t = solvers[i]->parchrono.getTime(RunningTime);
-            printf("c RunningTime_%zu : %f\n", i, t);
-            total_time += t;
-        }
-        printf("c RunningTime_total : %f\n", total_time);
+void DetParallelSolver::collectStats(StatsRecord& stats) {
+    stats.section("Basic stats", 2);
+    stats.set("Threads",       num_threads);
+    stats.set("Margin",        options.getMargin());
+    stats.set("Variables",     input_formula.getNumVars());
+    stats.set("Clauses",       input_formula.getNumClauses());
+    stats.set("TotalLiterals", input_formula.getTotalLiterals());
+    if (sharer)
+        sharer->reportStats(stats);
+    if (SchedNoise::isEnabled()) {
+        stats.section("Scheduling noise");
+        stats.set("Seed", options.getSchedNoise());
+        for (int p = 0; p < SchedNoise::NumPoints; p++)
+            stats.set(string("Delays") + SchedNoise::getName((SchedNoise::Point)p), SchedNoise::getNumDelays((SchedNoise::Point)p));
+        stats.section("Basic stats", 2);
+    }
+    if (portfolio)
+        for (size_t i=0; i < solvers.size(); i++)
+            stats.set(i, "Solver", portfolio->getSlot(i).name, false);
+    for (auto solver : solvers)
+        solver->reportStats(stats);
 
-        total_time = 0.0;
+    // clauses exported by thread j and received, promoted, evicted or used by the other threads
+    stats.section("Basic stats", 2);
+    for (size_t j=0; j < solvers.size(); j++) {
+        uint64_t received = 0, promoted = 0, evicted = 0, reasons = 0, conflicts = 0, retained = 0;
         for (size_t i=0; i < solvers.size(); i++) {
-            double t = solvers[i]->parchrono.getTime(WaitingTime);
-            printf("c WaitingTime_%zu : %f\n", i, t);
-            total_time += t;
+            const AbstDetSeqSolver::SourceStats& st = solvers[i]->getSourceStats(j);
+            received  += st.received;
+            promoted  += st.promoted;
+            evicted   += st.evicted;
+            reasons   += st.reasons;
+            conflicts += st.conflicts;
+            retained  += st.retained;
         }
-        printf("c WaitingTime_total : %f\n", total_time);
+        stats.set(j, "ReceivedFrom",  received,  false);
+        stats.set(j, "PromotedFrom",  promoted,  false);
+        stats.set(j, "EvictedFrom",   evicted,   false);
+        stats.set(j, "ReasonsFrom",   reasons,   false);
+        stats.set(j, "ConflictsFrom", conflicts, false);
+        stats.set(j, "RetainedFrom",  retained,  false);
+        stats.set(j, "UsesPerClauseFrom", StatsRecord::Value(received ? (double)(reasons + conflicts) / received : 0.0, 3), false);
+    }
 
-        total_time = 0.0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            double t = solvers[i]->parchrono.getTime(ExchangingTime);
-            printf("c ExchangingTime_%zu : %f\n", i, t);
-            total_time += t;
+    // usefulness matrices of imported clauses: the row of thread i lists the counts of clauses
+    // from source threads 0, 1, ... used as reasons, used as conflicts or retained by reductions
+    stats.section("Imported clause usefulness", 2);
+    for (size_t i=0; i < solvers.size(); i++) {
+        string reasons, conflicts, retained;
+        for (size_t j=0; j < solvers.size(); j++) {
+            const AbstDetSeqSolver::SourceStats& st = solvers[i]->getSourceStats(j);
+            const char *sep = j ? " " : "";
+            reasons   += sep + std::to_string(st.reasons);
+            conflicts += sep + std::to_string(st.conflicts);
+            retained  += sep + std::to_string(st.retained);
         }
-        printf("c ExchangingTime_total : %f\n", total_time);
+        stats.set(i, "ReasonMatrix",   reasons,   false);
+        stats.set(i, "ConflictMatrix", conflicts, false);
+        stats.set(i, "RetainedMatrix", retained,  false);
+    }
 
-        total_time = 0.0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            double t = solvers[i]->parchrono.getTime(PeriodUpdateTime);
-            printf("c PeriodProcTime_%zu : %f\n", i, t);
-            total_time += t;
-        }
-        printf("c PeriodProcTime_total : %f\n", total_time);
+    // distributions over all threads
+    stats.section("Time stats for parallel proccessing", 2);
+    static const char* hist_names[ProcTypes] = { "RunningTimeHist_total", "WaitingTimeHist_total", "ExchangingTimeHist_total", "PeriodProcTimeHist_total" };
+    for (int type = 0; type < ProcTypes; type++) {
+        TimeHistogram total_hist;
+        for (auto solver : solvers)
+            total_hist.merge(solver->parchrono.getHistogram((ProcName)type));
+        stats.set(hist_names[type], total_hist.toString());
+    }
 
-        vector<double> sum_non_waiting_time(solvers.size());
-        vector<double> sum_solve_time(solvers.size());
-        for (size_t i=0; i < solvers.size(); i++) {
-            sum_non_waiting_time[i] =
-                    solvers[i]->parchrono.getTime(RunningTime)
-                    + solvers[i]->parchrono.getTime(ExchangingTime)
-                    + solvers[i]->parchrono.getTime(PeriodUpdateTime);
-            sum_solve_time[i] =
-                    sum_non_waiting_time[i]
-                    + solvers[i]->parchrono.getTime(WaitingTime);
-        }
+    stats.section("System stats", 1);
+    stats.set("RealTime",      realTime() - start_real_time);
+    stats.set("CPUTime",       cpuTime());
+    stats.set("InitialMemory", used_mem_after_loading);
+    stats.set("UsedMemory",    usedMemory());
+    stats.set("PeakMemory",    peakMemory());
 
-        total_time = 0.0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            double t = sum_non_waiting_time[i];
-            printf("c NonWaitingTime_%zu : %f\n", i, t);
-            total_time += t;
-        }
-        printf("c NonWaitingTime_total : %f\n", total_time);
+    if (stats_callback)
+        stats_callback(stats);
+}
 
-        total_time = 0.0;
-        for (size_t i=0; i < solvers.size(); i++) {
-            double t = sum_solve_time[i];
-            printf("c SolvingTime_%zu : %f\n", i, t);
-            total_time += t;
+void DetParallelSolver::printResult() {
+    StatsRecord stats;
+    collectStats(stats);
+
+    stats.print(options.verbose());
+    if (options.hasStatsSink()) {
+        const char *result = getResult() == SAT ? "SAT" : getResult() == UNSAT ? "UNSAT" : "UNKNOWN";
+        try {
+            stats_sink.write(options.getStatsJSON(), options.getStatsCSV(), stats, result);
+        } catch (std::runtime_error& e) {
+            cout << "c Error: " << e.what() << endl;
         }
-        printf("c SolvingTime_total : %f\n", total_time);
-    }
-
-    if (options.verbose()) {
-        printf("c\n");
-        printf("c [System stats]\n");
-        printf("c RealTime : %f\n", realTime() - start_real_time);
-        printf("c CPUTime : %f\n", cpuTime());
-        printf("c InitialMemory : %f\n", used_mem_after_loading);
-        printf("c UsedMemory : %f\n", usedMemory());
-        printf("c PeakMemory : %f\n", peakMemory());    
-        printf("c\n");
     }
 
     switch (getResult()) {
@@ -407,10 +655,14 @@ void DetParallelSolver::printResult() {
     bool verify_model = options.getVerifyModel();
     if (getResult() == SAT && (show_model || verify_model)) {
         Model model = solvers[sharer->getWinner()]->getModel();
-        if (show_model) 
-            cout << model;
+        if (show_model) {
+            // the model is written at once (bypassing stdio) after flushing the preceding outputs
+            cout.flush();
+            fflush(stdout);
+            model.write(STDOUT_FILENO);
+        }
         if (verify_model) {
-            if (model.satisfies(input_formula)) 
+            if (verifyModel(model)) 
                 cout << "c Verified: found model satisfies the input formula" << endl;
             else {
                 cout << "c Error: found model does not satisfy the formula!" << endl;            
@@ -420,4 +672,8 @@ void DetParallelSolver::printResult() {
     }
     
     fflush(stdout);
+
+    // the process exits after the result is printed (including interrupts), so the shared memory
+    // segment is removed here
+    live_stats.close();
 }
@@ -3,10 +3,15 @@
 
 #include <vector> 
 #include <thread>
+#include <future>
+#include <atomic>
+#include <functional>
 
 // Include files should be specified relatively to avoid confusion with same named files.
 #include "Sharer.h"
 #include "Options.h"
+#include "Portfolio.h"
+#include "LiveStats.h"
 #include "../solvers/AbstDetSeqSolver.h"
 
 namespace DPS {
@@ -14,13 +19,27 @@ namespace DPS {
 using std::string;
 using std::vector;
 
+// Limits of a call of solve() (0 for unlimited). The conflict limit is checked by each thread at
+// the end of its periods and restarts (so it may be exceeded by a period), and the result is
+// deterministic unlike that of the real time limit.
+struct SolveLimits {
+    double   real_time;     // [s]
+    uint64_t conflicts;     // # of conflicts of each thread
+    SolveLimits(double t = 0, uint64_t c = 0) : real_time(t), conflicts(c) {}
+};
+
 class DetParallelSolver {
 protected:
     Sharer*                     sharer;    
+    Portfolio*                  portfolio;      // base solvers of threads
     uint32_t                    num_threads;    // number of threads
     vector<AbstDetSeqSolver*>   solvers;        // pointers to solver objects
     vector<pthread_t*>          threads;        // all threads of this process
     Instance                    input_formula;  // input formula
+    Instance                    added_formula;  // clauses added after the last call of solve() (incremental mode)
+    uint64_t                    num_loaded_clauses; // # of clauses of 'input_formula' loaded by the solvers
+    string                      loaded_file;    // the input file of the options loaded into 'input_formula'
+    bool                        incremental;    // the solvers are kept across calls of solve()
     Options                     options;        // options
 
     pthread_mutex_t             mfinished;      // mutex on which main process may wait for... As soon as one process finishes it release the mutex
@@ -30,20 +49,107 @@ protected:
     double used_mem_after_loading;              // used memory after loading input formula
 
     uint32_t num_print_stats;
+    StatsSink stats_sink;                       // progress records for --stats-json/--stats-csv
+    std::function<void(const StatsRecord&)> progress_callback;  // receives progress records (see setProgressCallback)
+    std::function<void(StatsRecord&)> stats_callback;           // completes final records (see setStatsCallback)
+    std::atomic<bool> stop_requested;           // set by interrupt()
+    LiveStats live_stats;                       // live counters in shared memory (--live-shm)
+
+    // worker threads kept across calls of solve() (see setReuseThreads)
+    struct Worker {
+        DetParallelSolver* owner;
+        uint32_t           index;               // the worker runs the task of a job with this index
+        pthread_t          thread;
+    };
+    bool                        reuse_threads;
+    vector<Worker*>             workers;
+    pthread_mutex_t             pool_mutex;
+    pthread_cond_t              pool_job;       // a new job or the shutdown is notified
+    pthread_cond_t              pool_done;      // all workers of the job have finished
+    uint64_t                    pool_gen;       // generation of the current job
+    uint32_t                    pool_running;   // # of workers running the current job
+    std::function<void(uint32_t)> pool_task;    // task of the current job (called with the index of each worker)
+    bool                        pool_shutdown;
 
-    void   generateAllSolvers();
+    SATResult solve(const vector<int>& assumptions, const vector<vector<int>>* cubes, const SolveLimits& limits);
+    bool   generateAllSolvers(bool keep_solved);
+    void   restartSolvers();
+    void   releaseSolvers();
+    bool   needsLoading() const { return !options.getInputFile().empty() && options.getInputFile() != loaded_file; }
+    std::future<Instance> startLoading();
+    void   waitLoading(std::future<Instance>& loading, double start);
+    void   checkNumVars();
+    void   writeTrace(const string& file);
+    void   runJob(std::function<void(uint32_t)> task);
+    void   waitJob();
+    void   stopWorkers();
+    static void *workerLoop(void *arg);
 
 public:
     DetParallelSolver();
     ~DetParallelSolver();
 
     void setOptions(int argc, const char* const argv[]) { options.setOptions(argc, argv); }
-    
-    // TODO: implement interface to input formula
-    // addClause(Clause& c)
+    // sets the options of the command line 'args' (without the program name), throws
+    // std::runtime_error on errors (the solvers kept by the incremental mode are released)
+    void setOptions(const vector<string>& args);
+    void setOptions(const Options& o) { options = o; releaseSolvers(); }
+    const Options& getOptions() const { return options; }
+    // keeps the threads alive to run the next call of solve() (false by default)
+    void setReuseThreads(bool b) { reuse_threads = b; }
+    // keeps the solvers with their learnt clauses across calls of solve() (false by default). Each
+    // call restarts the periods of all threads from 0, so the results are deterministic for a
+    // given sequence of calls. Kissat does not support this mode.
+    void setIncremental(bool b) { incremental = b; }
+    // calls 'callback' with the progress record at each 'log-interval' seconds of solve() (called
+    // by the thread calling solve())
+    void setProgressCallback(std::function<void(const StatsRecord&)> callback) { progress_callback = callback; }
+    // calls 'callback' at the end of collectStats to add the statistics of the caller to the record
+    // (e.g., the totals of CubeSolver over its calls of solve())
+    void setStatsCallback(std::function<void(StatsRecord&)> callback) { stats_callback = callback; }
+    // Stops the running call of solve() in the same way as the real time limit (the result is
+    // UNKNOWN unless a solution has been found). It may be called by any thread, and the following
+    // calls of solve() also stop immediately until clearInterrupt() is called.
+    void interrupt()      { stop_requested = true; }
+    void clearInterrupt() { stop_requested = false; }
+
+    // Clauses are accumulated over calls of solve(), and each call solves all of them (with
+    // the clauses of the input file if given) by new solver objects, or by the solvers of the
+    // last call in the incremental mode.
+    void addClause(const int *lits, size_t size) { input_formula.addClause(lits, size); }
+    void addClause(const vector<int>& lits)      { input_formula.addClause(lits.data(), lits.size()); }
+    // adds the 0-terminated clauses in 'lits[0] ... lits[num_lits-1]' (see Instance::addClauses)
+    uint64_t addClauses(const int *lits, size_t num_lits) { return input_formula.addClauses(lits, num_lits); }
+    const Instance& getFormula() const { return input_formula; }
+    // removes all clauses to solve another formula
+    void clearFormula() { input_formula = Instance(); num_loaded_clauses = 0; loaded_file.clear(); releaseSolvers(); }
+    // loads the input file of the options now (otherwise solve() loads it while constructing solvers)
+    void loadInputFile();
 
-    SATResult solve();
+    SATResult solve(const SolveLimits& limits = SolveLimits()) { return solve(vector<int>(), limits); }
+    // solves the clauses under the assumptions (literals assumed to be true only in this call)
+    SATResult solve(const vector<int>& assumptions, const SolveLimits& limits = SolveLimits()) { return solve(assumptions, nullptr, limits); }
+    // Solves the clauses under the assumptions 'cubes[i]' by thread i (the threads without cubes
+    // solve the clauses without assumptions) in the incremental mode. A thread that refutes its
+    // cube or reaches the conflict limit stops without stopping the others (see Sharer::setCubeMode),
+    // and the result is SAT or UNSAT only if a thread finds a model or refutes the clauses without
+    // its assumptions. The result of each thread is given by getCubeResult.
+    SATResult solveCubes(const vector<vector<int>>& cubes, const SolveLimits& limits = SolveLimits()) { return solve(vector<int>(), &cubes, limits); }
+    // the result of thread 'thn' in the last call of solveCubes() (UNSAT if the cube is refuted by
+    // the assumptions in 'failed')
+    SATResult getCubeResult(uint32_t thn, vector<int>& failed) const;
+    uint32_t  getNumThreads() const { return num_threads; }
     SATResult getResult() const { return sharer ? sharer->getResult() : UNKNOWN; }
+    // the model found by the last call of solve() (the result must be SAT)
+    Model     getModel();
+    // checks if 'model' satisfies the clauses, split into ranges checked by the worker threads
+    // (the same workers as the solvers if the threads are reused, otherwise they are created)
+    bool      verifyModel(const Model& model);
+    // the assumptions used to derive the UNSAT result of the last call of solve() by the winner
+    // (the result must be UNSAT, and it is empty if the clauses are UNSAT without assumptions)
+    const vector<int>& getFailedAssumptions();
+    // statistics of the last call of solve() (printed by printResult)
+    void      collectStats(StatsRecord& stats);
 
     bool      verbose() { return options.verbose(); }
     void      printStats();
@@ -0,0 +1,65 @@
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "LiveStats.h"
+
+using namespace DPS;
+
+void LiveStats::open(const std::string& _name, uint32_t num_threads) {
+    name = _name[0] == '/' ? _name : "/" + _name;
+    size = sizeof(LiveHeader) + sizeof(LiveSlot) * num_threads + alignof(LiveSlot);
+    // an existing object is not taken over since another run may be publishing in it
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST)
+        throw std::runtime_error("shared memory '" + name + "' already exists (used by another run, or left by a killed one "
+                                 "and removable from /dev/shm)");
+    if (fd < 0)
+        throw std::runtime_error("could not create shared memory '" + name + "': " + strerror(errno));
+    if (ftruncate(fd, size) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("could not resize shared memory '" + name + "': " + strerror(errno));
+    }
+    addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        addr = nullptr;
+        shm_unlink(name.c_str());
+        throw std::runtime_error("could not map shared memory '" + name + "': " + strerror(errno));
+    }
+
+    LiveHeader *header = new (addr) LiveHeader;
+    memcpy(header->magic, LIVE_MAGIC, sizeof(header->magic));
+    header->version     = LIVE_VERSION;
+    header->num_threads = num_threads;
+    header->slot_size   = sizeof(LiveSlot);
+    header->pid         = getpid();
+    header->start_time  = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    for (uint32_t i = 0; i < num_threads; i++) {
+        LiveSlot *slot = new (getSlot(i)) LiveSlot;
+        slot->state = LIVE_LOADING;
+        slot->period = slot->conflicts = slot->propagations = slot->imported = slot->exported = slot->update_time = 0;
+        for (uint32_t q = 0; q < LIVE_QUANTILES; q++)
+            slot->lbd_quantiles[q] = 0;
+    }
+}
+
+void LiveStats::close() {
+    if (addr == nullptr) return;
+    munmap(addr, size);
+    shm_unlink(name.c_str());
+    addr = nullptr;
+}
+
+// Slots start at the first offset after the header aligned to 'alignof(LiveSlot)' (128).
+LiveSlot* LiveStats::getSlot(uint32_t thn) {
+    size_t offset = (sizeof(LiveHeader) + alignof(LiveSlot) - 1) / alignof(LiveSlot) * alignof(LiveSlot);
+    return reinterpret_cast<LiveSlot *>(static_cast<char *>(addr) + offset) + thn;
+}
@@ -0,0 +1,70 @@
+#ifndef _DPS_LIVE_STATS_H_
+#define _DPS_LIVE_STATS_H_
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+namespace DPS {
+
+// Live counters of solver threads in a POSIX shared memory segment (the 'live-shm' option), which
+// external tools can map read-only (e.g., /dev/shm/<name> on Linux) while the solver is running.
+// Each thread only stores its own slot with relaxed atomic stores at the end of each period, so
+// readers never block the solver. The segment is removed when the solver exits.
+//
+// Layout: LiveHeader followed by 'num_threads' LiveSlots (each 'slot_size' bytes).
+// All fields are little-endian 64-bit integers (LBD quantiles are IEEE doubles).
+
+static const char     LIVE_MAGIC[8]  = { 'D', 'P', 'S', 'L', 'I', 'V', 'E', '\0' };
+static const uint32_t LIVE_VERSION   = 1;
+static const uint32_t LIVE_QUANTILES = 6;   // LBD quantiles of 5%, 10%, ..., 30%
+
+enum LiveState : uint64_t {
+    LIVE_LOADING  = 0,      // loading the input formula
+    LIVE_RUNNING  = 1,      // searching
+    LIVE_WAITING  = 2,      // waiting for clauses of other threads
+    LIVE_FINISHED = 3,
+};
+
+struct LiveHeader {
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    num_threads;
+    uint32_t    slot_size;
+    uint32_t    pid;
+    uint64_t    start_time;         // steady clock [ns] at creation
+};
+
+struct alignas(128) LiveSlot {      // one slot per cache-line pair to avoid false sharing
+    std::atomic<uint64_t> state;
+    std::atomic<uint64_t> period;
+    std::atomic<uint64_t> conflicts;
+    std::atomic<uint64_t> propagations;
+    std::atomic<uint64_t> imported;
+    std::atomic<uint64_t> exported;
+    std::atomic<uint64_t> update_time;                  // steady clock [ns] of the last update
+    std::atomic<uint64_t> lbd_quantiles[LIVE_QUANTILES];  // bits of doubles, refreshed every LIVE_LBD_INTERVAL periods
+};
+static const uint64_t LIVE_LBD_INTERVAL = 16;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && sizeof(std::atomic<uint64_t>) == 8,
+              "live counters must be lock-free to be shared between processes");
+
+class LiveStats {
+    std::string name;
+    void       *addr;
+    size_t      size;
+
+public:
+    LiveStats() : addr(nullptr), size(0) {}
+    ~LiveStats() { close(); }
+
+    // creates the segment '/name' (throws std::runtime_error on errors)
+    void      open(const std::string& name, uint32_t num_threads);
+    void      close();
+    LiveSlot* getSlot(uint32_t thn);
+};
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <pthread.h>
+#include <inttypes.h>
+#include <stdexcept>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "MemoryPlanner.h"
+#include "Sharer.h"
+#include "../solvers/SolverFactory.h"
+#include "../utils/System.h"
+
+using namespace DPS;
+using std::cout;
+using std::endl;
+
+static const double MB = 1024.0 * 1024.0;
+static const double PLAN_MEM_RATIO = 0.9;   // the rest of mem-lim is left for allocator slack and thread stacks
+
+MemoryPlanner::MemoryPlanner(Options& _options, Portfolio& _portfolio, const Instance& _formula) :
+    options(_options)
+,   portfolio(_portfolio)
+,   formula(_formula)
+{
+}
+
+MemoryPlanner::Plan MemoryPlanner::plan(uint32_t max_threads, bool keep_solved) {
+    double start = realTime();
+    Plan plan;
+
+    // the input formula is shared by all solvers
+    plan.shared_mem = sharedMemory(formula);
+
+    // the largest requirement among the slots of the portfolio
+    plan.base_mem     = 0;
+    plan.growth_mem   = 0;
+    plan.clause_bytes = 0;
+    plan.warmup_confs = 0;
+    plan.result       = UNKNOWN;
+    plan.solver       = nullptr;
+    plan.sharer       = nullptr;
+    plan.slot         = 0;
+    uint64_t reds = 0;
+    for (size_t i = 0; i < portfolio.size(); i++) {
+        Portfolio::Slot& slot = portfolio[i];
+        Probe p = probe(slot.name, slot.options, keep_solved);
+        if (p.solver) {
+            // the clauses are solved by a single thread, so the rest of the plan is not needed
+            plan.result       = p.result;
+            plan.solver       = p.solver;
+            plan.sharer       = p.sharer;
+            plan.slot         = i;
+            plan.num_threads  = 1;
+            plan.redundant_lim = 0;
+            plan.base_mem     = std::max(plan.base_mem, p.loaded_bytes / MB);
+            plan.warmup_confs = p.confs;
+            plan.time = realTime() - start;
+            return plan;
+        }
+        double growth = p.warm_bytes > p.loaded_bytes ? (p.warm_bytes - p.loaded_bytes) / MB : 0;
+        plan.base_mem = std::max(plan.base_mem, p.loaded_bytes / MB);
+        if (i == 0 || growth > plan.growth_mem) {
+            plan.growth_mem   = growth;
+            plan.warmup_confs = p.confs;
+        }
+        if (p.reds > 0)
+            plan.clause_bytes = std::max(plan.clause_bytes, (double)p.red_bytes / p.reds);
+        reds = std::max(reds, p.reds);
+    }
+
+    // each thread should be able to hold 'adjust-threads' times the clause DB grown in the warm-up
+    double avail = options.getMemUseLim() * PLAN_MEM_RATIO - plan.shared_mem;
+    double need  = plan.base_mem + options.getAdjustThreads() * plan.growth_mem;
+    uint32_t n = avail > 0 && need > 0 ? (uint32_t)std::min<double>(avail / need, max_threads) : 1;
+    if (n == 0) n = 1;
+    plan.num_threads = n;
+
+    // the rest of the budget of each thread is given to redundant clauses
+    plan.redundant_lim = 0;
+    if (plan.clause_bytes > 0) {
+        double budget = avail / n - plan.base_mem;
+        uint64_t lim = budget > 0 ? (uint64_t)(budget * MB / plan.clause_bytes) : 0;
+        plan.redundant_lim = std::max(lim, reds);   // at least the DB of the warm-up
+    }
+
+    plan.time = realTime() - start;
+    return plan;
+}
+
+double MemoryPlanner::sharedMemory(const Instance& formula) {
+    return (formula.getTotalLiterals() * sizeof(int) + (formula.getNumClauses() + 1) * sizeof(uint64_t)) / MB;
+}
+
+// The plan fits the threads in PLAN_MEM_RATIO of the same budget, so a planned thread stays under
+// this limit unless its clause DB outgrows the warm-up estimate.
+uint64_t MemoryPlanner::threadMemLimit(double mem_lim, const Instance& formula, uint32_t num_threads) {
+    double avail = (mem_lim - sharedMemory(formula)) / std::max(1u, num_threads);
+    return avail * MB >= 1 ? (uint64_t)(avail * MB) : 1;
+}
+
+// Loads the input formula into a probe solver (same id as thread 0) and runs it for a short
+// warm-up to measure the growth rate of the clause DB. The probe is kept if 'keep_solved' and the
+// warm-up solves the clauses.
+MemoryPlanner::Probe MemoryPlanner::probe(const string& name, Options& opts, bool keep_solved) {
+    Probe p;
+    Sharer *sharer = new Sharer(1, options.getMargin(), options.getMemAccLim(), options.getNonDetMode());
+    if (!sharer) throw std::runtime_error("could not allocate memory for Sharer");
+    AbstDetSeqSolver *solver = SolverFactory::createSATSolver(name, sharer, opts, 0);
+    solver->loadFormula(formula);
+    p.loaded_bytes = solver->getMemoryFootprint();
+
+    pthread_mutex_t mfinished;
+    pthread_cond_t  cfinished;
+    pthread_mutex_init(&mfinished, NULL);
+    pthread_cond_init(&cfinished, NULL);
+    solver->setFinishedSignal(&mfinished, &cfinished);
+    solver->setConflictLim(options.getPlanWarmup());
+    std::thread warmup([solver, sharer] {
+        sharer->incNumLiveThreads();
+        solver->solve();
+        sharer->decNumLiveThreads();
+    });
+    warmup.join();
+
+    p.warm_bytes = solver->getMemoryFootprint();
+    p.reds       = solver->getNumRedundantClauses();
+    p.red_bytes  = solver->getRedundantClauseBytes();
+    p.confs      = solver->getNumConflicts();
+    p.result     = solver->getLastResult();
+    p.solver     = nullptr;
+    p.sharer     = nullptr;
+    // the caller sets the finished signal of its own to the kept solver
+    solver->setFinishedSignal(nullptr, nullptr);
+    if (keep_solved && p.result != UNKNOWN) {
+        p.solver = solver;
+        p.sharer = sharer;
+    }
+    else {
+        delete solver;
+        delete sharer;
+    }
+    pthread_cond_destroy(&cfinished);
+    pthread_mutex_destroy(&mfinished);
+    return p;
+}
+
+void MemoryPlanner::printPlan(const Plan& plan) const {
+    cout << "c [Memory plan]" << endl;
+    cout << "c  shared memory    = " << plan.shared_mem << " MB" << endl;
+    cout << "c  base memory      = " << plan.base_mem << " MB / thread" << endl;
+    cout << "c  warm-up growth   = " << plan.growth_mem << " MB in " << plan.warmup_confs << " conflicts" << endl;
+    cout << "c  redundant clause = " << plan.clause_bytes << " bytes" << endl;
+    cout << "c  threads          = " << plan.num_threads << endl;
+    cout << "c  redundant lim    = " << plan.redundant_lim << " / thread" << endl;
+    cout << "c  planning time    = " << plan.time << " s" << endl;
+    cout << "c" << endl;
+}
@@ -0,0 +1,73 @@
+#ifndef _DPS_MEMORY_PLANNER_H_
+#define _DPS_MEMORY_PLANNER_H_
+
+#include <cstdint>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "Options.h"
+#include "Portfolio.h"
+#include "Sharer.h"
+#include "../solvers/AbstDetSeqSolver.h"
+#include "../sat/Instance.h"
+
+namespace DPS {
+
+// Plans # of threads and the clause DB limit of each thread to fit in 'mem-lim'.
+// The input formula is loaded into a probe solver whose footprint and growth rate over
+// a short warm-up run are measured by the memory estimators of the base solver.
+// Only the estimators (not RSS) are used, so the plan is deterministic. For a portfolio, each
+// slot is measured and the largest requirement is assumed for every thread.
+// The warm-up is not limited so as to stay unsolved: if it solves the clauses, planning stops and
+// the result is kept by returning the probe solver, which the caller takes over as a single thread.
+class MemoryPlanner {
+public:
+    struct Plan {
+        uint32_t num_threads;       // # of threads that fit in the memory limit
+        uint64_t redundant_lim;     // limit on # of redundant clauses per thread (0 for unlimited)
+        double   shared_mem;        // memory of the shared input formula [MB]
+        double   base_mem;          // memory of a solver just after loading [MB]
+        double   growth_mem;        // memory growth of a solver in the warm-up [MB]
+        double   clause_bytes;      // average bytes of a redundant clause
+        uint64_t warmup_confs;      // # of conflicts in the warm-up
+        double   time;              // time for planning
+        SATResult         result;   // result of the warm-up that solved the clauses (UNKNOWN otherwise)
+        AbstDetSeqSolver* solver;   // the probe solver that solved the clauses (owned by the caller)
+        Sharer*           sharer;   // the sharer of 'solver' (owned by the caller)
+        size_t            slot;     // portfolio slot of 'solver'
+    };
+
+    MemoryPlanner(Options& options, Portfolio& portfolio, const Instance& formula);
+
+    // A warm-up that solves the clauses is kept only if 'keep_solved' (the warm-up does not take the
+    // assumptions and the incremental mode into account), and it is thrown away otherwise.
+    Plan plan(uint32_t max_threads, bool keep_solved);
+    void printPlan(const Plan& plan) const;
+
+    // memory of the input formula shared by all solvers [MB]
+    static double sharedMemory(const Instance& formula);
+    // estimated bytes that each of 'num_threads' solvers may use in 'mem_lim' [MB] (at least 1)
+    static uint64_t threadMemLimit(double mem_lim, const Instance& formula, uint32_t num_threads);
+
+private:
+    // memory usage of a probe solver
+    struct Probe {
+        uint64_t loaded_bytes;      // footprint after loading
+        uint64_t warm_bytes;        // footprint after the warm-up
+        uint64_t reds;              // # of redundant clauses after the warm-up
+        uint64_t red_bytes;         // bytes of redundant clauses after the warm-up
+        uint64_t confs;             // # of conflicts in the warm-up
+        SATResult         result;   // result of the warm-up
+        AbstDetSeqSolver* solver;   // the probe solver if it solved the clauses and is kept
+        Sharer*           sharer;   // the sharer of 'solver'
+    };
+
+    Options&        options;
+    Portfolio&      portfolio;
+    const Instance& formula;
+
+    Probe probe(const string& name, Options& opts, bool keep_solved);
+};
+
+}
+
+#endif
@@ -1,9 +1,11 @@
 #include <iostream>
 #include <string>
+#include <stdexcept>
 
 // Include files should be specified relatively to avoid confusion with same named files.
 #include "Options.h"
 #include "Version.h"
+#include "../sat/InputDecoder.h"
 
 namespace DPS {
 
@@ -19,7 +21,8 @@ cxxopts::Options Options::makeDefaultOptions() {
     
     options.add_options()
         ("h,help",        "print this list of all command line options")
-        ("i,input",       "input dimacs file",                   cxxopts::value<std::string>())
+        ("i,input",       "input dimacs file (" + InputDecoder::supportedFormats() + ")", cxxopts::value<std::string>())
+        ("decode-threads", "# of threads for decompressing input (0 for # of CPUs)", cxxopts::value<uint32_t>()->default_value("0"), "N")
         ("model",         "show model when SAT",                 cxxopts::value<bool>()->default_value("false"))
         ("verify",        "verify model",                        cxxopts::value<bool>()->default_value("false"))
         ("real-time-lim", "real time limit (0 for unlimited)",   cxxopts::value<double>()->default_value("0"), "N")
@@ -28,20 +31,42 @@ cxxopts::Options Options::makeDefaultOptions() {
         ("log-interval",  "interval of log output",              cxxopts::value<uint32_t>()->default_value("10"), "N")
         ("v,verbose",     "verbose level",                       cxxopts::value<uint32_t>()->default_value("1"), "N")
         ("q,quiet",       "quiet mode",                          cxxopts::value<bool>()->default_value("false"))
+        ("trace",         "write the timeline of periods to FILE in Chrome trace format", cxxopts::value<string>()->default_value(""), "FILE")
+        ("stats-json",    "write progress and final statistics to FILE in JSON", cxxopts::value<string>()->default_value(""), "FILE")
+        ("stats-csv",     "write progress and final statistics to FILE in CSV",  cxxopts::value<string>()->default_value(""), "FILE")
+        ("perf",          "measure hardware counters (cycles, instructions, LLC/branch misses) of each thread and period (Linux)", cxxopts::value<bool>()->default_value("false"))
+        ("live-shm",      "publish live counters of threads in the POSIX shared memory NAME", cxxopts::value<string>()->default_value(""), "NAME")
+        ("sched-noise",   "inject random delays with SEED at synchronization points of threads to test determinism (0 for none)", cxxopts::value<uint64_t>()->default_value("0"), "SEED")
+        ("sched-noise-us", "maximum length of an injected delay [us]", cxxopts::value<uint32_t>()->default_value("200"), "N")
+        ("batch",         "solve the instances listed in the input file (one path per line) or in the input directory, and print a result line per instance",
+                                                                 cxxopts::value<bool>()->default_value("false"))
+        ("batch-jobs",    "# of instances solved concurrently in the batch mode (the threads are divided among them)",
+                                                                 cxxopts::value<uint32_t>()->default_value("1"), "N")
+        ("daemon",        "serve solving jobs on the unix domain socket PATH (see README)",
+                                                                 cxxopts::value<string>()->default_value(""), "PATH")
+        ("daemon-jobs",   "# of jobs solved concurrently by the daemon (the threads are divided among them)",
+                                                                 cxxopts::value<uint32_t>()->default_value("1"), "N")
     ;
 
     options.add_options("Parallel solving")
-        ("s,solver",       "base solver name (minisat/glucose/mcomsps/kissat)",  cxxopts::value<string>()->default_value("kissat"), "NAME")
+        ("s,solver",       "base solver name (minisat/glucose/mcomsps/kissat) or portfolio of them (e.g., 'kissat:24,mcomsps:4/mc-lbd=4,glucose')",
+                                                                   cxxopts::value<string>()->default_value("kissat"), "SPEC")
         ("n,nthreads",     "number of threads (0 for automatic)",                cxxopts::value<uint32_t>()->default_value("0"),       "N")
         ("m,margin",       "margin for delayed clause exchange",                 cxxopts::value<uint32_t>()->default_value("20"),      "N")
         ("p,period",       "# of memory accesses for a period",                  cxxopts::value<uint64_t>()->default_value("1000000"), "N")
         ("non-det",        "non-deterministic mode",                             cxxopts::value<bool>()->default_value("false"))
-        ("adjust-threads", "adjust # of threads to avoid consuming all memory s.t. init memory size * N * # of threads <= mem-lim (0 as no-adjust)",
+        ("adjust-threads", "adjust # of threads to avoid consuming all memory s.t. each thread can hold N times the clause DB grown in the warm-up within mem-lim (0 as no-adjust)",
                                                                    cxxopts::value<uint32_t>()->default_value("3"), "N")
-        ("fapp-clauses",   "imported clauses limit for forced application (0 for unlimited)", 
-                                                                   cxxopts::value<uint32_t>()->default_value("10000"), "N")
-        ("fapp-periods",   "minimum period-interval for forced application (0 for unlimited)", 
+        ("plan-warmup",    "# of conflicts of the warm-up run to measure memory growth for adjust-threads",
+                                                                   cxxopts::value<uint32_t>()->default_value("2000"), "N")
+        ("fapp-periods",   "minimum period-interval for forced application of imported unit clauses (0 for unlimited)", 
                                                                    cxxopts::value<uint32_t>()->default_value("50"), "N")
+        ("prob-confs",     "# of conflicts for which an imported clause is on probation and evicted unless used (0 for no probation, Kissat reviews them at each reduction)",
+                                                                   cxxopts::value<uint32_t>()->default_value("0"), "N")
+        ("profile",        "diversification profiles of base solvers (comma-separated built-in names (painless/pakis) or files)",
+                                                                   cxxopts::value<string>()->default_value("painless"), "SPEC")
+        ("acc-scale",      "# of memory accesses of the base solver counted as one access of a period (0 for automatic calibration in heterogeneous portfolios)",
+                                                                   cxxopts::value<double>()->default_value("0"), "N")
         ("adpt-prd",       "adaptive period-length strategy (specify # of conflicts / period, 0 means unuse)",
                                                                    cxxopts::value<uint32_t>()->default_value("0"), "N")
         ("adpt-prd-lb",    "lb of adaptive period-length (specify # of mem accs, 0 means unuse)",
@@ -56,6 +81,12 @@ cxxopts::Options Options::makeDefaultOptions() {
                                                                    cxxopts::value<uint32_t>()->default_value("150"), "N")
         ("exp-lits-margin", "allowable margin of exported ltierals",
                                                                    cxxopts::value<double>()->default_value("3"), "N")
+        ("cube",           "cube-and-conquer mode (cubes split by lookahead are solved by threads in rounds, requires minisat/glucose/mcomsps)",
+                                                                   cxxopts::value<bool>()->default_value("false"))
+        ("cube-confs",     "# of conflicts of each thread in a round of the cube mode (cubes not solved within it are split)",
+                                                                   cxxopts::value<uint64_t>()->default_value("10000"), "N")
+        ("cube-factor",    "# of cubes per thread split in advance in the cube mode",
+                                                                   cxxopts::value<uint32_t>()->default_value("4"), "N")
     ;
 
     options.add_options("SAT solver - MiniSAT")
@@ -79,7 +110,8 @@ cxxopts::Options Options::makeDefaultOptions() {
         ("ks-lbd",      "initial upper-bound of clause LBD for export (0 for unlimited)",   cxxopts::value<uint32_t>()->default_value("3"), "N")        
         ("ks-stable",   "stable mode search (0: focus, 1: alt, 2: stable, 4: mix)",         cxxopts::value<uint32_t>()->default_value("1"), "N")        
         ("ks-elim",     "percentage of threads applying elimination",                       cxxopts::value<uint32_t>()->default_value("50"))
-        ("ks-pakis",    "use PaKis search parameters for diversification",                  cxxopts::value<bool>()->default_value("false"))
+        ("ks-pakis",    "use PaKis search parameters for diversification (same as adding 'pakis' to profile)",
+                                                                                            cxxopts::value<bool>()->default_value("false"))
     ;
 
     options.parse_positional({"input"});
@@ -89,27 +121,38 @@ cxxopts::Options Options::makeDefaultOptions() {
 
 static const char* const default_argv[] = { "DPS" };
 void Options::setOptions(int argc, const char* const argv[]) {
+    try {
+        parseOptions(argc, argv, true);
+    } catch (std::runtime_error& e) {
+        cout << "Error: " << e.what() << endl;
+        exit(0);
+    }
+}
+
+void Options::parseOptions(int argc, const char* const argv[], bool cli) {
     auto options = makeDefaultOptions();
     cxxopts::ParseResult result;
+    if (argv != nullptr)
+        args.assign(argv, argv + argc);
+    else
+        args.assign(default_argv, default_argv + 1);
     try {        
         if (argv != nullptr) 
             result = options.parse(argc, argv);
         else
             result = options.parse(1, default_argv);
     } catch (cxxopts::OptionException& e) {
-        cout << "Error: " << e.what() << " (try '-h')" << endl;
-        exit(0);
+        throw std::runtime_error(string(e.what()) + " (try '-h')");
     }    
     if (result.count("help")) {
+        if (!cli) throw std::runtime_error("option '-h' is only available in the command line");
         cout << options.help() << endl;
         exit(0);
     }
-    if (result.unmatched().size() > 0) {
-        for (const auto& arg : result.unmatched())
-            cout << "Error: unsupported argument '" << arg << "' (try '-h')" << endl;      
-        exit(0);
-    }
+    if (result.unmatched().size() > 0)
+        throw std::runtime_error("unsupported argument '" + result.unmatched()[0] + "' (try '-h')");
     if (result.count("banner")) {
+        if (!cli) throw std::runtime_error("option '--banner' is only available in the command line");
         cout << "DPS (Deterministic Parallel SAT Solver) version " << VERSION << endl;
         cout << COPYRIGHT << endl;
         cout << BUILD_INFO << endl;
@@ -118,20 +161,34 @@ void Options::setOptions(int argc, const char* const argv[]) {
     
     // apply parsed options
     if (result.count("input")) setInputFile(result["input"].as<string>());
+    setDecodeThreads(result["decode-threads" ].as<uint32_t>());
     setShowModel    (result["model"          ].as<bool>());
     setVerifyModel  (result["verify"         ].as<bool>());
     setRealTimeLim  (result["real-time-lim"  ].as<double>());
     setMemUseLim    (result["mem-lim"        ].as<double>());
     setLogInterval  (result["log-interval"   ].as<uint32_t>());
     setVerboseLv    (result["quiet"          ].as<bool>() ? 0 : result["verbose"].as<uint32_t>());
+    setTraceFile    (result["trace"          ].as<string>());
+    setStatsJSON    (result["stats-json"     ].as<string>());
+    setStatsCSV     (result["stats-csv"      ].as<string>());
+    setLiveShm      (result["live-shm"       ].as<string>());
+    setPerf         (result["perf"           ].as<bool>());
+    setSchedNoise   (result["sched-noise"    ].as<uint64_t>());
+    setSchedNoiseUs (result["sched-noise-us" ].as<uint32_t>());
+    setBatch        (result["batch"          ].as<bool>());
+    setBatchJobs    (result["batch-jobs"     ].as<uint32_t>());
+    setDaemon       (result["daemon"         ].as<string>());
+    setDaemonJobs   (result["daemon-jobs"    ].as<uint32_t>());
     setNumThreads   (result["nthreads"       ].as<uint32_t>());
     setMargin       (result["margin"         ].as<uint32_t>());
     setMemAccLim    (result["period"         ].as<uint64_t>());
     setNonDetMode   (result["non-det"        ].as<bool>());
     setBaseSolver   (result["solver"         ].as<string>());
     setAdjustThreads(result["adjust-threads" ].as<uint32_t>());
-    setFAppClauses  (result["fapp-clauses"   ].as<uint32_t>());
+    setPlanWarmup   (result["plan-warmup"    ].as<uint32_t>());
     setFAppPeriods  (result["fapp-periods"   ].as<uint32_t>());
+    setProbConfs    (result["prob-confs"     ].as<uint32_t>());
+    setAccScale     (result["acc-scale"      ].as<double>());
     setAdptPrd      (result["adpt-prd"       ].as<uint32_t>());
     setAdptPrdLB    (result["adpt-prd-lb"    ].as<uint64_t>());
     setAdptPrdUB    (result["adpt-prd-ub"    ].as<uint64_t>());
@@ -139,6 +196,9 @@ void Options::setOptions(int argc, const char* const argv[]) {
     setExpLBDQLim   (result["exp-lbdq-lim"   ].as<double>());
     setExpLitsLim   (result["exp-lits-lim"   ].as<uint32_t>());
     setExpLitsMargin(result["exp-lits-margin"].as<double>());
+    setCube         (result["cube"           ].as<bool>());
+    setCubeConfs    (result["cube-confs"     ].as<uint64_t>());
+    setCubeFactor   (result["cube-factor"    ].as<uint32_t>());
     setMSLenLim     (result["ms-len"         ].as<uint32_t>());
     setMSSimp       (result["ms-simp"        ].as<bool>());
     setGLLBDLim     (result["gl-lbd"         ].as<uint32_t>());
@@ -151,6 +211,37 @@ void Options::setOptions(int argc, const char* const argv[]) {
     setKSStable     (result["ks-stable"      ].as<uint32_t>());
     setKSElim       (result["ks-elim"        ].as<uint32_t>());
     setKSPaKis      (result["ks-pakis"       ].as<bool>());
+    setProfile(result["profile"].as<string>() + (getKSPaKis() ? ",pakis" : ""));
+}
+
+Options Options::withOverrides(const std::vector<string>& overrides) const {
+    std::vector<string> strs(args);
+    for (const string& o : overrides)
+        strs.push_back("--" + o);
+    std::vector<const char*> argv;
+    for (const string& s : strs)
+        argv.push_back(s.c_str());
+    Options opts;
+    opts.parseOptions(argv.size(), argv.data());
+    // the limits and the verbosity set by the batch and daemon modes after parsing are not in 'args'
+    // (they are global options, which the overrides cannot change)
+    opts.setRealTimeLim (real_time_lim);
+    opts.setMemUseLim   (mem_use_lim);
+    opts.setMemLimPerJob(mem_lim_per_job);
+    opts.setLogInterval (log_interval);
+    opts.setVerboseLv   (verbose_lv);
+    return opts;
+}
+
+Options Options::withArgs(const std::vector<string>& extra) const {
+    std::vector<const char*> argv;
+    for (const string& s : args)
+        argv.push_back(s.c_str());
+    for (const string& s : extra)
+        argv.push_back(s.c_str());
+    Options opts;
+    opts.parseOptions(argv.size(), argv.data());
+    return opts;
 }
 
 void Options::printOptions() {
@@ -161,8 +252,10 @@ void Options::printOptions() {
     cout << "c  period           = " << mem_acc_lim << endl;
     cout << "c  non det          = " << non_det << endl;
     cout << "c  adjust threads   = " << adjust_threads << endl;
-    cout << "c  fapp clauses     = " << fapp_clauses << endl;
+    cout << "c  plan warmup      = " << plan_warmup << endl;
     cout << "c  fapp periods     = " << fapp_periods << endl;
+    cout << "c  prob confs       = " << prob_confs << endl;
+    cout << "c  acc scale        = " << acc_scale << endl;
     cout << "c  adpt prd         = " << adpt_prd << endl;
     cout << "c  adpt prd lb      = " << adpt_prd_lb << endl;
     cout << "c  adpt prd ub      = " << adpt_prd_ub << endl;
@@ -170,6 +263,8 @@ void Options::printOptions() {
     cout << "c  exp lbdq lim     = " << exp_lbdq_lim << endl;
     cout << "c  exp lits lim     = " << exp_lits_lim << endl;
     cout << "c  exp lits margin  = " << exp_lits_margin << endl;
+    if (cube)
+        cout << "c  cube confs       = " << cube_confs << " (factor " << cube_factor << ")" << endl;
     cout << "c  ms len           = " << ms_len_lim << endl;
     cout << "c  ms simp          = " << ms_simp << endl;
     cout << "c  gl lbd           = " << gl_lbd_lim << endl;
@@ -182,9 +277,32 @@ void Options::printOptions() {
     cout << "c  ks stable        = " << ks_stable << endl;
     cout << "c  ks elim          = " << ks_elim << endl;
     cout << "c  ks pakis         = " << ks_pakis << endl;
+    cout << "c  decode threads   = " << decode_threads << endl;
     cout << "c  real time lim    = " << real_time_lim << endl;
     cout << "c  memory lim       = " << mem_use_lim << endl;
+    if (!trace_file.empty())
+        cout << "c  trace file       = " << trace_file << endl;
+    if (!stats_json.empty())
+        cout << "c  stats json       = " << stats_json << endl;
+    if (!stats_csv.empty())
+        cout << "c  stats csv        = " << stats_csv << endl;
+    if (perf)
+        cout << "c  perf             = " << perf << endl;
+    if (!live_shm.empty())
+        cout << "c  live shm         = " << live_shm << endl;
+    if (sched_noise)
+        cout << "c  sched noise      = " << sched_noise << " (max " << sched_noise_us << " us)" << endl;
+    if (batch)
+        cout << "c  batch jobs       = " << batch_jobs << endl;
+    if (!daemon.empty())
+        cout << "c  daemon           = " << daemon << " (" << daemon_jobs << " jobs)" << endl;
+    cout << "c  profile          = " << profile_spec << endl;
     cout << "c" << endl;
+    if (!profile.empty()) {
+        cout << "c [Profile]" << endl;
+        profile.printProfile();
+        cout << "c" << endl;
+    }
 }
 
 }
\ No newline at end of file
@@ -2,8 +2,10 @@
 #define _DPS_OPTIONS_H_
 
 #include <string>
+#include <vector>
 
 // Include files should be specified relatively to avoid confusion with same named files.
+#include "Profile.h"
 #include "../utils/cxxopts.hpp"
 
 namespace DPS {
@@ -12,14 +14,32 @@ using std::string;
 
 class Options {
 private:
+    std::vector<string> args;   // command line arguments (used to derive the options of portfolio slots)
+
     // basic options
     string      input_file;
+    uint32_t    decode_threads;
     bool        show_model;
     bool        verify_model;
     double      real_time_lim;
     double      mem_use_lim;
+    bool        mem_lim_per_job = false;    // mem-lim is the share of a job in a process solving several instances (not a command line option)
     uint32_t    log_interval;
     uint32_t    verbose_lv;
+    string      trace_file;
+    string      stats_json;
+    string      stats_csv;
+    string      live_shm;
+    bool        perf;
+    uint64_t    sched_noise;
+    uint32_t    sched_noise_us;
+    bool        batch;
+    uint32_t    batch_jobs;
+    string      daemon;
+    uint32_t    daemon_jobs;
+    bool        cube;
+    uint64_t    cube_confs;
+    uint32_t    cube_factor;
     
     // parallel solving options
     string      base_solver;
@@ -28,8 +48,12 @@ private:
     uint64_t    mem_acc_lim;
     bool        non_det;
     uint32_t    adjust_threads;
-    uint32_t    fapp_clauses;
+    uint32_t    plan_warmup;
     uint32_t    fapp_periods;
+    uint32_t    prob_confs;
+    double      acc_scale;
+    string      profile_spec;
+    Profile     profile;
     uint32_t    adpt_prd;
     uint64_t    adpt_prd_lb;
     uint64_t    adpt_prd_ub;
@@ -63,12 +87,26 @@ private:
 public:
     Options() { setOptions(); }
 
+    // parses the command line (errors are printed and the process exits)
     void setOptions(int argc = 0, const char* const argv[] = nullptr);
+    // parses the command line (throws std::runtime_error on errors, used by the library API). The
+    // help and the banner are printed and the process exits only for the command line ('cli'),
+    // otherwise they are rejected as errors.
+    void parseOptions(int argc, const char* const argv[], bool cli = false);
     void printOptions();
+    // Returns the options parsed from the same command line followed by 'overrides' (e.g., "ks-stable=2"),
+    // keeping the limits and the verbosity set after parsing,
+    // throws std::runtime_error on errors.
+    Options withOverrides(const std::vector<string>& overrides) const;
+    // Returns the options parsed from the same command line followed by 'args' (e.g., "-s", "minisat"),
+    // throws std::runtime_error on errors.
+    Options withArgs(const std::vector<string>& args) const;
 
     // basic options
     void          setInputFile(string s)            { input_file = s; }
     const string& getInputFile()              const { return input_file; }
+    void          setDecodeThreads(uint32_t n)      { decode_threads = n; }
+    uint32_t      getDecodeThreads()          const { return decode_threads; }
     void          setShowModel(bool b)              { show_model = b; }
     bool          getShowModel()              const { return show_model; }
     void          setVerifyModel(bool b)            { verify_model = b; }
@@ -77,16 +115,47 @@ public:
     double        getRealTimeLim()            const { return real_time_lim; }
     void          setMemUseLim(double t)            { mem_use_lim = t; }  
     double        getMemUseLim()              const { return mem_use_lim; }
+    void          setMemLimPerJob(bool b)           { mem_lim_per_job = b; }
+    bool          getMemLimPerJob()           const { return mem_lim_per_job; }
     void          setLogInterval(uint32_t n)        { log_interval = n; }  
     uint32_t      getLogInterval()            const { return log_interval; }
     void          setVerboseLv(uint32_t n)          { verbose_lv = n; }
     uint32_t      getVerboseLv()              const { return verbose_lv; }
     uint32_t      verbose()                   const { return verbose_lv; }
+    void          setTraceFile(string s)            { trace_file = s; }
+    const string& getTraceFile()              const { return trace_file; }
+    void          setStatsJSON(string s)            { stats_json = s; }
+    const string& getStatsJSON()              const { return stats_json; }
+    void          setStatsCSV(string s)             { stats_csv = s; }
+    const string& getStatsCSV()               const { return stats_csv; }
+    bool          hasStatsSink()              const { return !stats_json.empty() || !stats_csv.empty(); }
+    void          setLiveShm(string s)              { live_shm = s; }
+    const string& getLiveShm()                const { return live_shm; }
+    void          setPerf(bool b)                   { perf = b; }
+    bool          getPerf()                   const { return perf; }
+    void          setSchedNoise(uint64_t n)         { sched_noise = n; }
+    uint64_t      getSchedNoise()             const { return sched_noise; }
+    void          setSchedNoiseUs(uint32_t n)       { sched_noise_us = n; }
+    uint32_t      getSchedNoiseUs()           const { return sched_noise_us; }
+    void          setBatch(bool b)                  { batch = b; }
+    bool          getBatch()                  const { return batch; }
+    void          setBatchJobs(uint32_t n)          { batch_jobs = n; }
+    uint32_t      getBatchJobs()              const { return batch_jobs; }
+    void          setDaemon(string s)               { daemon = s; }
+    const string& getDaemon()                 const { return daemon; }
+    void          setDaemonJobs(uint32_t n)         { daemon_jobs = n; }
+    uint32_t      getDaemonJobs()             const { return daemon_jobs; }
+    void          setCube(bool b)                   { cube = b; }
+    bool          getCube()                   const { return cube; }
+    void          setCubeConfs(uint64_t n)          { cube_confs = n; }
+    uint64_t      getCubeConfs()              const { return cube_confs; }
+    void          setCubeFactor(uint32_t n)         { cube_factor = n; }
+    uint32_t      getCubeFactor()             const { return cube_factor; }
     void          quiet()                           { verbose_lv = 0; }
 
     // parallel solving options
     void          setBaseSolver(string n)           { base_solver = n; }
-    string        getBaseSolver()                   { return base_solver; }
+    const string& getBaseSolver()              const { return base_solver; }
     void          setNumThreads(uint32_t n)         { num_threads = n; }               
     uint32_t      getNumThreads()             const { return num_threads; }
     void          setMargin(uint32_t n)             { margin = n; }
@@ -97,10 +166,17 @@ public:
     uint64_t      getNonDetMode()             const { return non_det; }
     void          setAdjustThreads(uint32_t n)      { adjust_threads = n; }
     uint32_t      getAdjustThreads()          const { return adjust_threads; }
-    void          setFAppClauses(uint32_t n)        { fapp_clauses = n; }
-    uint32_t      getFAppClauses()            const { return fapp_clauses; }
+    void          setPlanWarmup(uint32_t n)         { plan_warmup = n; }
+    uint32_t      getPlanWarmup()             const { return plan_warmup; }
     void          setFAppPeriods(uint32_t n)        { fapp_periods = n; }
     uint32_t      getFAppPeriods()            const { return fapp_periods; }
+    void          setProbConfs(uint32_t n)          { prob_confs = n; }
+    uint32_t      getProbConfs()              const { return prob_confs; }
+    void          setAccScale(double d)             { acc_scale = d; }
+    double        getAccScale()               const { return acc_scale; }
+    void          setProfile(string s)              { profile_spec = s; profile = Profile(); profile.load(s); }
+    const string& getProfileSpec()            const { return profile_spec; }
+    const Profile& getProfile()               const { return profile; }
     void          setAdptPrd(uint32_t n)            { adpt_prd = n; }
     uint32_t      getAdptPrd()                const { return adpt_prd; }
     void          setAdptPrdLB(uint64_t n)          { adpt_prd_lb = n; }
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "Portfolio.h"
+#include "../solvers/SolverFactory.h"
+
+using namespace DPS;
+using std::cout;
+using std::endl;
+
+// options shared by all threads (periods and the termination must be agreed by all threads)
+static const char* const global_options[] = {
+    "h", "help", "i", "input", "decode-threads", "model", "verify", "real-time-lim", "mem-lim", "banner",
+    "log-interval", "trace", "stats-json", "stats-csv", "live-shm", "perf", "sched-noise", "sched-noise-us", "batch", "batch-jobs", "daemon", "daemon-jobs", "v", "verbose", "q", "quiet", "s", "solver", "n", "nthreads", "m", "margin", "p", "period",
+    "non-det", "adjust-threads", "plan-warmup", "adpt-prd", "adpt-prd-lb", "adpt-prd-ub", "adpt-prd-smth",
+    "cube", "cube-confs", "cube-factor",
+};
+
+static std::vector<string> split(const string& s, char delim) {
+    std::vector<string> items;
+    std::stringstream ss(s);
+    string item;
+    while (std::getline(ss, item, delim))
+        items.push_back(item);
+    return items;
+}
+
+Portfolio::Portfolio(const Options& options) {
+    const string& spec = options.getBaseSolver();
+    std::vector<string> items = split(spec, ',');
+    if (items.empty())
+        throw std::runtime_error("empty solver spec");
+    slots.reserve(items.size());
+    for (const string& item : items) {
+        std::vector<string> fields = split(item, '/');
+        if (fields.empty() || fields[0].empty())
+            throw std::runtime_error("empty slot in solver spec '" + spec + "'");
+        Slot slot;
+        slot.weight = 0;
+        slot.count  = 0;
+        slot.first  = 0;
+        // name[:threads]
+        size_t colon = fields[0].find(':');
+        slot.name = fields[0].substr(0, colon);
+        if (!SolverFactory::isSolverName(slot.name))
+            throw std::runtime_error("unknown solver name '" + slot.name + "' in solver spec '" + spec + "'");
+        if (colon != string::npos) {
+            const string num = fields[0].substr(colon + 1);
+            if (num.empty() || num.find_first_not_of("0123456789") != string::npos || std::stoul(num) == 0)
+                throw std::runtime_error("invalid # of threads '" + num + "' in solver spec '" + spec + "'");
+            slot.weight = std::stoul(num);
+        }
+        // option overrides
+        for (size_t i = 1; i < fields.size(); i++) {
+            const string& o = fields[i];
+            const string key = o.substr(0, o.find('='));
+            if (key.empty())
+                throw std::runtime_error("invalid option override '" + o + "' in solver spec '" + spec + "'");
+            if (isGlobalOption(key))
+                throw std::runtime_error("option '" + key + "' can not be overridden per solver");
+            slot.overrides.push_back(o);
+        }
+        slot.options = slot.overrides.empty() ? options : options.withOverrides(slot.overrides);
+        slot.options.setBaseSolver(slot.name);
+        slot.acc_scale = slot.options.getAccScale();
+        slots.push_back(slot);
+    }
+}
+
+uint32_t Portfolio::getSpecNumThreads() const {
+    uint32_t sum = 0;
+    for (const Slot& slot : slots) {
+        if (slot.weight == 0) return 0;
+        sum += slot.weight;
+    }
+    return sum;
+}
+
+void Portfolio::assign(uint32_t num_threads) {
+    // unspecified slots share the threads left by the specified ones
+    uint64_t specified = 0, unspecified = 0;
+    for (const Slot& slot : slots) {
+        specified += slot.weight;
+        if (slot.weight == 0) unspecified++;
+    }
+    uint64_t rest = num_threads > specified ? num_threads - specified : 0;
+    std::vector<uint64_t> weights;
+    uint64_t k = 0;
+    for (const Slot& slot : slots) {
+        if (slot.weight > 0)
+            weights.push_back(slot.weight);
+        else {
+            weights.push_back(std::max<uint64_t>(1, rest / unspecified + (k < rest % unspecified ? 1 : 0)));
+            k++;
+        }
+    }
+    uint64_t total = 0;
+    for (uint64_t w : weights) total += w;
+
+    // largest remainder method (ties are broken by the order of slots)
+    std::vector<uint32_t> counts(slots.size());
+    std::vector<uint64_t> remainders(slots.size());
+    uint32_t assigned = 0;
+    for (size_t i = 0; i < slots.size(); i++) {
+        counts[i]     = num_threads * weights[i] / total;
+        remainders[i] = num_threads * weights[i] % total;
+        assigned += counts[i];
+    }
+    while (assigned < num_threads) {
+        size_t best = 0;
+        for (size_t i = 1; i < slots.size(); i++)
+            if (remainders[i] > remainders[best]) best = i;
+        counts[best]++;
+        remainders[best] = 0;
+        assigned++;
+    }
+    // each slot has at least one thread if possible
+    if (num_threads >= slots.size()) {
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (counts[i] > 0) continue;
+            size_t max = 0;
+            for (size_t j = 1; j < slots.size(); j++)
+                if (counts[j] > counts[max]) max = j;
+            counts[max]--;
+            counts[i]++;
+        }
+    }
+
+    setCounts(counts);
+    setAccScales();
+}
+
+void Portfolio::assignOne(size_t slot) {
+    std::vector<uint32_t> counts(slots.size(), 0);
+    counts[slot] = 1;
+    setCounts(counts);
+}
+
+void Portfolio::setCounts(const std::vector<uint32_t>& counts) {
+    uint32_t first = 0;
+    for (size_t i = 0; i < slots.size(); i++) {
+        slots[i].count = counts[i];
+        slots[i].first = first;
+        first += counts[i];
+    }
+}
+
+void Portfolio::setAccScales() {
+    // memory accesses are normalised only if different base solvers are mixed
+    bool hetero = isHeterogeneous();
+    for (Slot& slot : slots)
+        if (slot.acc_scale == 0)
+            slot.options.setAccScale(hetero ? SolverFactory::getDefaultAccScale(slot.name) : 1.0);
+}
+
+bool Portfolio::isHeterogeneous() const {
+    const string *name = nullptr;
+    for (const Slot& slot : slots) {
+        if (slot.count == 0) continue;
+        if (name == nullptr) 
+            name = &slot.name;
+        else if (slot.name != *name)
+            return true;
+    }
+    return false;
+}
+
+size_t Portfolio::getSlotIndex(uint32_t thn) const {
+    for (size_t i = 0; i < slots.size(); i++)
+        if (slots[i].first <= thn && thn < slots[i].first + slots[i].count)
+            return i;
+    throw std::runtime_error("no portfolio slot for thread " + std::to_string(thn));
+}
+
+bool Portfolio::isGlobalOption(const string& name) {
+    for (const char *o : global_options)
+        if (name == o) return true;
+    return false;
+}
+
+void Portfolio::printPortfolio() const {
+    cout << "c [Portfolio]" << endl;
+    for (const Slot& slot : slots) {
+        cout << "c  " << slot.name << string(slot.name.size() < 16 ? 16 - slot.name.size() : 0, ' ') << " = " << slot.count << " threads";
+        if (slot.count > 0)
+            cout << " (" << slot.first << "-" << slot.first + slot.count - 1 << ")";
+        for (const string& o : slot.overrides)
+            cout << " " << o;
+        cout << ", acc scale " << slot.options.getAccScale() << endl;
+    }
+    cout << "c" << endl;
+}
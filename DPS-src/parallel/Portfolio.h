@@ -0,0 +1,63 @@
+#ifndef _DPS_PORTFOLIO_H_
+#define _DPS_PORTFOLIO_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "Options.h"
+
+namespace DPS {
+
+using std::string;
+
+// A portfolio of base solvers given by the 'solver' option, e.g., 'kissat:24,mcomsps:4/mc-lbd=4,glucose'.
+// Each comma-separated slot consists of a solver name, an optional # of threads and optional
+// option overrides separated by '/'. Threads are assigned to slots in the given order, so the
+// thread IDs (and the diversification based on them) are deterministic.
+class Portfolio {
+public:
+    struct Slot {
+        string              name;       // base solver name
+        uint32_t            weight;     // # of threads in the spec (0 if unspecified)
+        uint32_t            count;      // # of threads assigned to this slot
+        uint32_t            first;      // thread ID of the first solver of this slot
+        std::vector<string> overrides;  // option overrides (e.g., "mc-lbd=4")
+        Options             options;    // options with the overrides applied
+        double              acc_scale;  // scale of memory accesses given by the options (0 if determined by the portfolio)
+    };
+
+    Portfolio(const Options& options);
+
+    // # of threads given by the spec (0 if some slot has no # of threads)
+    uint32_t getSpecNumThreads() const;
+    // assigns 'num_threads' threads to slots in proportion to their weights and determines the
+    // scale of memory accesses of each slot
+    void     assign(uint32_t num_threads);
+    // assigns a single thread to slot 'slot' (the solver taken over from the warm-up of MemoryPlanner),
+    // which keeps the scale of memory accesses determined by the last call of 'assign'
+    void     assignOne(size_t slot);
+
+    bool        isHeterogeneous()           const;
+    size_t      size()                      const { return slots.size(); }
+    Slot&       operator[](size_t i)              { return slots[i]; }
+    const Slot& operator[](size_t i)        const { return slots[i]; }
+    size_t      getSlotIndex(uint32_t thn)  const;
+    const Slot& getSlot(uint32_t thn)       const { return slots[getSlotIndex(thn)]; }
+    Options&    getOptions(uint32_t thn)          { return slots[getSlotIndex(thn)].options; }
+
+    void printPortfolio() const;
+
+private:
+    std::vector<Slot> slots;    // must not be reallocated after parsing since solvers refer to the options
+
+    void setCounts(const std::vector<uint32_t>& counts);
+    void setAccScales();
+
+    static bool isGlobalOption(const string& name);
+};
+
+}
+
+#endif
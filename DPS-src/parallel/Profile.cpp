@@ -0,0 +1,169 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "Profile.h"
+#include "../solvers/SolverFactory.h"
+
+using namespace DPS;
+using std::cout;
+using std::endl;
+
+// built-in profiles
+static const char* const builtin_profiles[][2] = {
+    // diversification strategy of MapleCOMSPS in painless
+    { "painless",
+        "[mcomsps]\n"
+        "VSIDS=1 pick_strict=1\n"
+        "VSIDS=0 pick_strict=1\n"
+        "VSIDS=1 pick_strict=0\n"
+        "VSIDS=0 pick_strict=0\n"
+    },
+    // search parameters of PaKis
+    { "pakis",
+        "[kissat]\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=1 phase=1\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=2 phase=1\n"
+        "tier1=2 chrono=1 stable=0 walkinitially=0 target=1 phase=1\n"
+        "tier1=2 chrono=0 stable=1 walkinitially=0 target=1 phase=1\n"
+        "tier1=2 chrono=0 stable=1 walkinitially=0 target=1 phase=0\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=1 phase=0\n"
+        "tier1=2 chrono=0 stable=2 walkinitially=0 target=1 phase=1\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=0 phase=1\n"
+        "tier1=2 chrono=0 stable=1 walkinitially=0 target=0 phase=0\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=0 phase=0\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=1 target=1 phase=1\n"
+        "tier1=2 chrono=0 stable=1 walkinitially=0 target=2 phase=1\n"
+        "tier1=2 chrono=0 stable=1 walkinitially=0 target=2 phase=0\n"
+        "tier1=3 chrono=0 stable=1 walkinitially=0 target=2 phase=0\n"
+        "tier1=3 chrono=0 stable=1 walkinitially=0 target=2 phase=1\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=2 phase=0\n"
+        "tier1=2 chrono=0 stable=2 walkinitially=0 target=2 phase=1\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=0 phase=1\n"
+        "tier1=2 chrono=0 stable=1 walkinitially=0 target=0 phase=0\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=0 target=0 phase=0\n"
+        "tier1=3 chrono=1 stable=1 walkinitially=0 target=0 phase=1\n"
+        "tier1=3 chrono=1 stable=1 walkinitially=0 target=2 phase=1\n"
+        "tier1=2 chrono=1 stable=1 walkinitially=1 target=2 phase=1\n"
+        "tier1=2 chrono=0 stable=0 walkinitially=0 target=1 phase=1\n"
+    },
+};
+
+void Profile::load(const string& spec) {
+    std::stringstream ss(spec);
+    string name;
+    while (std::getline(ss, name, ',')) {
+        if (name.empty()) continue;
+        bool found = false;
+        for (const auto& p : builtin_profiles) {
+            if (name == p[0]) {
+                std::istringstream in(p[1]);
+                parse(in, name);
+                found = true;
+                break;
+            }
+        }
+        if (found) continue;
+        std::ifstream in(name);
+        if (!in)
+            throw std::runtime_error("unknown profile or could not open profile file '" + name + "'");
+        parse(in, name);
+    }
+}
+
+void Profile::parse(std::istream& in, const string& source) {
+    std::map<string, Section> parsed;
+    Section *section = nullptr;
+    string   solver;
+    string   line;
+    for (uint32_t lineno = 1; std::getline(in, line); lineno++) {
+        string where = "profile '" + source + "' line " + std::to_string(lineno) + ": ";
+        size_t hash = line.find('#');
+        if (hash != string::npos) line.erase(hash);
+        std::istringstream tokens(line);
+        string token;
+        if (!(tokens >> token)) continue;   // empty line
+
+        // section header
+        if (token[0] == '[') {
+            if (token.back() != ']' || (tokens >> token))
+                throw std::runtime_error(where + "invalid section header");
+            solver = token.substr(1, token.size() - 2);
+            if (!SolverFactory::isSolverName(solver))
+                throw std::runtime_error(where + "unknown solver name '" + solver + "'");
+            section = &parsed[solver];
+            continue;
+        }
+        if (section == nullptr)
+            throw std::runtime_error(where + "parameters outside of a section");
+
+        // optional thread index
+        bool     has_thn = false;
+        uint32_t thn = 0;
+        if (token.back() == ':') {
+            string num = token.substr(0, token.size() - 1);
+            if (num.empty() || num.find_first_not_of("0123456789") != string::npos)
+                throw std::runtime_error(where + "invalid thread index '" + num + "'");
+            thn = std::stoul(num);
+            has_thn = true;
+            if (!(tokens >> token))
+                throw std::runtime_error(where + "no parameters for thread " + num);
+        }
+
+        Params params;
+        do {
+            size_t eq = token.find('=');
+            if (eq == string::npos || eq == 0 || eq + 1 == token.size())
+                throw std::runtime_error(where + "invalid parameter '" + token + "' (expected name=value)");
+            string key = token.substr(0, eq);
+            string val = token.substr(eq + 1);
+            size_t pos = 0;
+            double value = 0;
+            try { value = std::stod(val, &pos); } catch (std::exception&) { pos = 0; }
+            if (pos != val.size())
+                throw std::runtime_error(where + "invalid value '" + val + "' of parameter '" + key + "'");
+            if (!SolverFactory::isValidParam(solver, key, value))
+                throw std::runtime_error(where + "invalid parameter '" + token + "' for " + solver);
+            params.emplace_back(key, value);
+        } while (tokens >> token);
+
+        if (has_thn)
+            section->fixed[thn] = params;
+        else
+            section->cyclic.push_back(params);
+    }
+    for (auto& s : parsed)
+        sections[s.first] = s.second;
+}
+
+const Profile::Params& Profile::getParams(const string& solver, uint32_t thn) const {
+    static const Params none;
+    auto it = sections.find(solver);
+    if (it == sections.end()) return none;
+    const Section& section = it->second;
+    auto fit = section.fixed.find(thn);
+    if (fit != section.fixed.end()) return fit->second;
+    if (section.cyclic.empty()) return none;
+    return section.cyclic[thn % section.cyclic.size()];
+}
+
+void Profile::printProfile() const {
+    for (const auto& s : sections) {
+        const Section& section = s.second;
+        size_t n = section.cyclic.size();
+        for (size_t i = 0; i < n; i++) {
+            cout << "c  " << s.first << " T%" << n << "=" << i << " :";
+            for (const auto& p : section.cyclic[i])
+                cout << " " << p.first << "=" << p.second;
+            cout << endl;
+        }
+        for (const auto& f : section.fixed) {
+            cout << "c  " << s.first << " T" << f.first << " :";
+            for (const auto& p : f.second)
+                cout << " " << p.first << "=" << p.second;
+            cout << endl;
+        }
+    }
+}
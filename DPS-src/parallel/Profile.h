@@ -0,0 +1,48 @@
+#ifndef _DPS_PROFILE_H_
+#define _DPS_PROFILE_H_
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <istream>
+
+namespace DPS {
+
+using std::string;
+
+// Diversification profiles assign parameters of base solvers to each thread. A profile is a
+// built-in name (see 'builtin_profiles' in Profile.cpp) or a file in the following format:
+//
+//   # comment
+//   [kissat]                    section of a base solver (minisat/glucose/mcomsps/kissat)
+//   tier1=3 chrono=0            parameters of the threads i s.t. i % (# of such lines) == 0
+//   tier1=2 target=2            ... i % (# of such lines) == 1
+//   5: stable=0                 parameters of thread 5 (taken instead of the lines above)
+//
+// The thread index is the thread ID (not the index within the slot of a portfolio). If several
+// profiles are given, the section of a later profile replaces that of an earlier one.
+class Profile {
+public:
+    typedef std::vector<std::pair<string, double>> Params;
+
+    // loads comma-separated profile names or files (throws std::runtime_error on errors)
+    void load(const string& spec);
+
+    const Params& getParams(const string& solver, uint32_t thn) const;
+    bool          empty() const { return sections.empty(); }
+    void          printProfile() const;
+
+private:
+    struct Section {
+        std::vector<Params>        cyclic;  // parameters assigned in a round-robin way
+        std::map<uint32_t, Params> fixed;   // parameters of specific threads
+    };
+    std::map<string, Section> sections;
+
+    void parse(std::istream& in, const string& source);
+};
+
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "Sharer.h"
 #include "../solvers/AbstDetSeqSolver.h"
+#include "../utils/SchedNoise.h"
 
 using namespace DPS;
 using namespace std;
@@ -13,12 +14,14 @@ Sharer::Sharer(uint32_t _num_threads, uint32_t _margin, uint64_t _mem_acc_lim, b
 ,   margin(_margin)    
 ,   mem_acc_lim(_mem_acc_lim)
 ,   non_det(_non_det)
+,   cube_mode(false)
 ,   num_live_threads(0)
 ,   lanched(false)
 ,   sol_found(false)
 ,   final_result(UNKNOWN)
 ,   winner_period(0)
 ,   winner_id(-1)
+,   interrupted(false)
 {
     // assert(queues.size() == 0);
     pcqm = new PrdClausesQueueMgr(num_threads);
@@ -26,7 +29,9 @@ Sharer::Sharer(uint32_t _num_threads, uint32_t _margin, uint64_t _mem_acc_lim, b
     pthread_mutex_init(&mutexJobFinished, NULL); // This is the shared companion lock
 }
 
-Sharer::~Sharer() {}
+Sharer::~Sharer() {
+    delete pcqm;
+}
 
 void Sharer::incNumLiveThreads() {
     assert(num_live_threads >= 0);
@@ -47,7 +52,9 @@ int Sharer::getNumLiveSolvers() {
 }
 
 void Sharer::completeCurrPeriod(int thn, uint64_t prd_len) {
+    SchedNoise::inject(SchedNoise::PeriodEnd);
     pcqm->get(thn).completeAddtion(prd_len);
+    SchedNoise::inject(SchedNoise::PeriodEnd);
 }
 
 bool Sharer::shouldBeTerminated(uint64_t prd) {
@@ -55,23 +62,25 @@ bool Sharer::shouldBeTerminated(uint64_t prd) {
     pthread_mutex_lock(&mutexJobFinished);  // TODO: read only mutex is available here.
     // modified by nabesima
     //shared_lock<shared_mutex> lock(mutexJobFinished);       // readers can access simultaneously
-    ret = sol_found && (final_result == UNKNOWN || winner_period + margin < prd || non_det);
+    ret = sol_found && (interrupted || winner_period + margin < prd || non_det);
     pthread_mutex_unlock(&mutexJobFinished);
     return ret;
 }
 
-bool Sharer::IFinished(SATResult status, uint64_t prd, int thn) {
+bool Sharer::IFinished(SATResult status, uint64_t prd, int thn, bool exact) {
     bool found_better_one = false;
 
+    SchedNoise::inject(SchedNoise::Finish);
     pthread_mutex_lock(&mutexJobFinished);
     //lock_guard<shared_mutex> lock(mutexJobFinished);
 
     assert(status == UNKNOWN || final_result == UNKNOWN || final_result == status);
 
     // modified by nabesima
+    // stops by the conflict limit are ordered in the same way as solutions (see AbstDetSeqSolver::finish)
     if (!sol_found
-            || (status != UNKNOWN && prd <  winner_period)
-            || (status != UNKNOWN && prd == winner_period && thn < winner_id)
+            || (exact && !interrupted && prd <  winner_period)
+            || (exact && !interrupted && prd == winner_period && thn < winner_id)
        ) {
         found_better_one = true;
         sol_found        = true;
@@ -79,8 +88,12 @@ bool Sharer::IFinished(SATResult status, uint64_t prd, int thn) {
         winner_period    = prd;   
         final_result     = status;
     }
+    // the other threads may wait for the periods that this thread does not complete
+    if (!exact)
+        interrupted = true;
 
     pthread_mutex_unlock(&mutexJobFinished);
+    SchedNoise::inject(SchedNoise::Finish);
     return found_better_one;
 }
 
@@ -88,3 +101,11 @@ PrdClausesQueue& Sharer::get(int thread_id) const {
     assert(0 <= thread_id);
     return pcqm->get(thread_id);
 }
+
+void Sharer::reportStats(StatsRecord& stats) {
+    stats.section("Basic stats", 2);
+    if (final_result != UNKNOWN) {
+        stats.set("Winner", winner_id);
+        stats.set("WinnerPeriod", winner_period);
+    }
+}
@@ -5,6 +5,7 @@
 
 #include "../period/PrdClausesQueue.h"
 #include "../period/PrdClausesQueueMgr.h"
+#include "../utils/Stats.h"
 
 namespace DPS {
 
@@ -34,12 +35,21 @@ public:
 
     void completeCurrPeriod(int thn, uint64_t prd_len);
     bool shouldBeTerminated(uint64_t prd);
-    bool IFinished(SATResult status,uint64_t prd,int thn);
+    // 'exact' is true if the thread stopped at a point that does not depend on the timing of
+    // threads (a solution or the conflict limit), otherwise all threads are interrupted
+    bool IFinished(SATResult status,uint64_t prd,int thn, bool exact = true);
 
     PrdClausesQueue& get(int thread_id) const;
+
+    // In the cube mode, each thread solves its own cube (assumptions), and a thread refuting its
+    // cube or reaching the conflict limit retires without stopping the others (see
+    // AbstDetSeqSolver::finish). A model or a refutation without assumptions ends all threads.
+    void setCubeMode(bool b) { cube_mode = b; }
+    bool isCubeMode() const  { return cube_mode; }
     
     int getWinner() {return winner_id; }
     SATResult getResult() { return final_result; }
+    void reportStats(StatsRecord& stats);
     
 
 protected:
@@ -47,6 +57,7 @@ protected:
     uint32_t margin;
     uint64_t mem_acc_lim;
     bool     non_det;
+    bool     cube_mode;
 
     std::atomic<int> num_live_threads;
     std::atomic<bool> lanched;
@@ -54,6 +65,7 @@ protected:
     std::atomic<SATResult> final_result;
     uint64_t winner_period;
     int winner_id;
+    bool interrupted;           // a thread stopped at a point depending on the timing (e.g., time limit)
     
     PrdClausesQueueMgr * pcqm;
     
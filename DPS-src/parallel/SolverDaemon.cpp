@@ -0,0 +1,435 @@
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <chrono>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "SolverDaemon.h"
+#include "BatchSolver.h"
+#include "../utils/System.h"
+
+using namespace DPS;
+using std::cout;
+using std::endl;
+
+void SolverDaemon::Client::send(const string& msg) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed) return;
+    string data = msg + "\n";
+    const char *p = data.data();
+    size_t left = data.size();
+    while (left > 0) {
+        ssize_t n = ::send(fd, p, left, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {           // the connection is closed by the peer
+            broken = true;
+            return;
+        }
+        p    += n;
+        left -= n;
+    }
+}
+
+bool SolverDaemon::Client::readLine(string& line) {
+    char tmp[65536];
+    while (true) {
+        size_t eol = buf.find('\n');
+        if (eol != string::npos) {
+            line = buf.substr(0, eol);
+            buf.erase(0, eol + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            return true;
+        }
+        ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf.append(tmp, n);
+    }
+}
+
+SolverDaemon::SolverDaemon(const Options& _options) :
+    options(_options)
+,   path(_options.getDaemon())
+,   num_jobs(1)
+,   job_threads(1)
+,   job_mem_lim(0)
+,   listen_fd(-1)
+,   num_arrivals(0)
+,   num_done(0)
+,   stopping(false)
+{
+    if (options.getShowModel() || options.getBatch())
+        throw std::runtime_error("the daemon mode does not support --model and --batch (use 'model=1' of jobs)");
+    if (!options.getTraceFile().empty() || options.hasStatsSink() || !options.getLiveShm().empty())
+        throw std::runtime_error("the daemon mode does not support --trace, --stats-json, --stats-csv and --live-shm");
+
+    // the threads and the memory limit are divided among the workers (the share of the memory limit
+    // is checked against the estimators of the solvers of each job, see DetParallelSolver::solve)
+    uint32_t num_threads = options.getNumThreads();
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+    num_jobs    = std::max(1u, options.getDaemonJobs());
+    job_threads = std::max(1u, num_threads / num_jobs);
+    job_mem_lim = options.getMemUseLim() / num_jobs;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error("too long socket path '" + path + "'");
+    strcpy(addr.sun_path, path.c_str());
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+        throw std::runtime_error(string("could not create a socket (") + strerror(errno) + ")");
+    unlink(path.c_str());   // left by the last daemon
+    // only the user of the daemon can connect (the socket is created with mode 0600 regardless of
+    // the umask, and no other thread runs yet)
+    mode_t mask = umask(0177);
+    int ret = bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(mask);
+    if (ret != 0 || chmod(path.c_str(), 0600) != 0 || listen(listen_fd, 64) != 0) {
+        string error = strerror(errno);
+        close(listen_fd);
+        throw std::runtime_error("could not listen on '" + path + "' (" + error + ")");
+    }
+}
+
+SolverDaemon::~SolverDaemon() {
+    for (Worker *w : workers)
+        delete w;
+}
+
+int SolverDaemon::run() {
+    cout << "c Daemon: listening on " << path << " by " << num_jobs << " jobs of " << job_threads << " threads" << endl;
+
+    for (uint32_t i = 0; i < num_jobs; i++) {
+        Worker *w = new Worker;
+        w->dps.setReuseThreads(true);
+        workers.push_back(w);
+        w->thread = std::thread(&SolverDaemon::runWorker, this, w);
+    }
+
+    while (true) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            if (fd >= 0) close(fd);
+            break;
+        }
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            cout << "c Daemon: accept failed (" << strerror(errno) << ")" << endl;
+            break;
+        }
+        std::shared_ptr<Client> client = std::make_shared<Client>(fd);
+        clients.push_back(client);
+        std::thread(&SolverDaemon::serveClient, this, client).detach();
+    }
+
+    stop();
+    for (Worker *w : workers)
+        w->thread.join();
+    {
+        // wakes up the readers of the connections
+        std::unique_lock<std::mutex> lock(mutex);
+        for (auto& c : clients)
+            shutdown(c->fd, SHUT_RDWR);
+        while (!clients.empty())
+            clients_cv.wait(lock);
+    }
+    close(listen_fd);
+    unlink(path.c_str());
+
+    cout << "c Daemon: " << num_done << " jobs done" << endl;
+    return 0;
+}
+
+// A worker takes the queued job of the highest priority (the earliest one among them).
+void SolverDaemon::runWorker(Worker *w) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        while (!stopping && queue.empty())
+            queued_cv.wait(lock);
+        if (stopping) break;
+        auto it = std::min_element(queue.begin(), queue.end(),
+            [](const std::shared_ptr<Job>& a, const std::shared_ptr<Job>& b) {
+                return a->prio > b->prio || (a->prio == b->prio && a->seq < b->seq);
+            });
+        std::shared_ptr<Job> job = *it;
+        queue.erase(it);
+        w->job = job;
+        w->dps.clearInterrupt();    // the interrupts are given only to the running job (see cancel)
+        lock.unlock();
+
+        job->client->send("started " + job->id);
+        job->client->send(solveJob(w->dps, *job));
+
+        lock.lock();
+        w->job = nullptr;
+        num_done++;
+        clients_cv.notify_all();
+    }
+}
+
+string SolverDaemon::solveJob(DetParallelSolver& dps, Job& job) {
+    try {
+        dps.setOptions(job.options);
+        dps.clearFormula();
+        if (!job.lits.empty()) {
+            dps.addClauses(job.lits.data(), job.lits.size());
+            vector<int>().swap(job.lits);
+        }
+        if (job.progress > 0) {
+            std::shared_ptr<Client> client = job.client;
+            string id = job.id;
+            dps.setProgressCallback([client, id](const StatsRecord& progress) {
+                StatsRecord::Value time, confs, cps;
+                progress.get("RealTime", time);
+                progress.get("Conflicts_total", confs);
+                progress.get("ConfsPerSec", cps);
+                char buf[128];
+                snprintf(buf, sizeof(buf), " time=%.3f conflicts=%lld confs/s=%lld", time.d, (long long)confs.i, (long long)cps.d);
+                client->send("progress " + id + buf);
+            });
+        }
+        SATResult status = dps.solve(job.limits);
+        dps.setProgressCallback(nullptr);
+
+        string reply = "result " + job.id + " ";
+        reply += status == SAT ? "SAT" : status == UNSAT ? "UNSAT" : job.cancelled ? "CANCELLED" : "UNKNOWN";
+        reply += BatchSolver::resultFields(dps, status);
+        if (status == SAT && job.model) {
+            vector<char> buf;
+            dps.getModel().format(buf);
+            reply += "\n";
+            reply.append(buf.begin(), buf.end() - 1);
+        }
+        return reply;
+    } catch (std::exception& e) {
+        dps.setProgressCallback(nullptr);
+        return "error " + job.id + " " + e.what();
+    }
+}
+
+void SolverDaemon::serveClient(std::shared_ptr<Client> client) {
+    string line;
+    while (client->readLine(line)) {
+        std::istringstream ss(line);
+        vector<string> words;
+        string w;
+        while (ss >> w)
+            words.push_back(w);
+        if (words.empty()) continue;
+
+        const string& cmd = words[0];
+        string id = words.size() > 1 ? words[1] : "-";
+        if (cmd == "solve") {
+            std::shared_ptr<Job> job;
+            try {
+                job = parseJob(client, words);
+                if (!job) break;    // the connection is closed in the inline clauses
+            } catch (std::exception& e) {
+                client->send("error " + id + " " + e.what());
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) {
+                client->send("error " + id + " the daemon is stopping");
+                continue;
+            }
+            job->seq = num_arrivals++;
+            queue.push_back(job);
+            client->send("queued " + id);   // sent before 'started' by holding the lock
+            queued_cv.notify_one();
+        }
+        else if (cmd == "cancel" && words.size() == 2)
+            cancel(client.get(), id, true);
+        else if (cmd == "status") {
+            std::lock_guard<std::mutex> lock(mutex);
+            size_t running = std::count_if(workers.begin(), workers.end(), [](Worker *w) { return w->job != nullptr; });
+            client->send("status queued=" + std::to_string(queue.size()) + " running=" + std::to_string(running)
+                + " done=" + std::to_string(num_done));
+        }
+        else if (cmd == "shutdown")
+            stop();
+        else
+            client->send("error - unknown request '" + line + "'");
+    }
+
+    // The replies are sent until the jobs are done unless the connection is closed (the writing
+    // side may be shut down after the requests).
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!client->broken && hasJobs(client.get())) {
+        struct pollfd pfd = { client->fd, 0, 0 };
+        if (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR))) break;
+        clients_cv.wait_for(lock, std::chrono::milliseconds(200));
+    }
+    lock.unlock();
+    cancel(client.get(), "", false);
+    lock.lock();
+    clients.erase(std::find(clients.begin(), clients.end(), client));
+    {
+        std::lock_guard<std::mutex> client_lock(client->mutex);
+        client->closed = true;
+        close(client->fd);
+    }
+    clients_cv.notify_all();
+}
+
+// Parses the request 'solve <id> [key=value ...] [-- <options>]' and reads the inline clauses
+// following it (returns nullptr if the connection is closed before 'end').
+std::shared_ptr<SolverDaemon::Job> SolverDaemon::parseJob(std::shared_ptr<Client> client, const vector<string>& words) {
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->client = client;
+    if (words.size() < 2 || words[1] == "--" || words[1].find('=') != string::npos)
+        throw std::runtime_error("no job id");
+    job->id = words[1];
+
+    vector<string> params, args;
+    size_t i = 2;
+    for (; i < words.size() && words[i] != "--"; i++)
+        params.push_back(words[i]);
+    for (i++; i < words.size(); i++)
+        args.push_back(words[i]);
+    string file;
+    for (const string& p : params)
+        if (p.compare(0, 5, "file=") == 0)
+            file = p.substr(5);
+
+    // the inline clauses are read before any errors are reported to keep the stream in sync
+    if (file.empty()) {
+        string line, error;
+        while (true) {
+            if (!client->readLine(line)) return nullptr;
+            size_t b = line.find_first_not_of(" \t");
+            if (b == string::npos) continue;
+            if (line.compare(b, string::npos, "end") == 0) break;
+            if (line[b] == 'c' || line[b] == 'p' || !error.empty()) continue;
+            const char *s = line.c_str() + b;
+            while (true) {
+                char *e;
+                errno = 0;
+                long lit = strtol(s, &e, 10);
+                if (e == s) break;
+                s += strspn(s, " \t");
+                if (errno == ERANGE || lit < -INT_MAX || lit > INT_MAX) {
+                    error = "literal '" + string(s, e - s) + "' is out of range";
+                    break;
+                }
+                job->lits.push_back((int)lit);
+                s = e;
+            }
+            s += strspn(s, " \t");
+            if (error.empty() && *s != '\0')
+                error = string("invalid literal '") + s + "'";
+        }
+        if (!error.empty())
+            throw std::runtime_error(error);
+        if (!job->lits.empty() && job->lits.back() != 0)
+            job->lits.push_back(0);
+    }
+
+    for (const string& p : params) {
+        size_t eq = p.find('=');
+        if (eq == string::npos)
+            throw std::runtime_error("invalid parameter '" + p + "'");
+        string key = p.substr(0, eq), val = p.substr(eq + 1);
+        if      (key == "prio")      job->prio             = std::stoi(val);
+        else if (key == "time")      job->limits.real_time = std::stod(val);
+        else if (key == "conflicts") job->limits.conflicts = std::stoull(val);
+        else if (key == "progress")  job->progress         = std::stoul(val);
+        else if (key == "model")     job->model            = val != "0";
+        else if (key != "file")
+            throw std::runtime_error("unknown parameter '" + key + "'");
+    }
+
+    // options printing information and exiting, and those of the process are not accepted
+    for (const string& a : args)
+        if (a == "--help" || a == "--banner" || a.compare(0, 6, "--batch") == 0 || a.compare(0, 8, "--daemon") == 0
+                || (a.size() > 1 && a[0] == '-' && a[1] != '-' && a.find('h') != string::npos))
+            throw std::runtime_error("option '" + a + "' is not accepted by jobs");
+    Options o = options.withArgs(args);
+    // options writing to files or shared memory named by the client (with the permissions of the
+    // daemon and colliding between concurrent jobs) and the process-global scheduling noise
+    if (!o.getTraceFile().empty() || o.hasStatsSink() || !o.getLiveShm().empty()
+            || o.getSchedNoise() != options.getSchedNoise() || o.getSchedNoiseUs() != options.getSchedNoiseUs())
+        throw std::runtime_error("options --trace, --stats-json, --stats-csv, --live-shm, --sched-noise and --sched-noise-us are not accepted by jobs");
+    o.quiet();
+    o.setShowModel(false);
+    o.setDaemon("");
+    o.setInputFile(file);
+    if (o.getNumThreads() == 0 || o.getNumThreads() > job_threads)
+        o.setNumThreads(job_threads);
+    if (o.getDecodeThreads() == 0)
+        o.setDecodeThreads(job_threads);
+    if (job_mem_lim > 0 && (o.getMemUseLim() == 0 || o.getMemUseLim() > job_mem_lim))
+        o.setMemUseLim(job_mem_lim);
+    o.setMemLimPerJob(true);
+    if (job->progress > 0)
+        o.setLogInterval(job->progress);
+    job->options = o;
+    return job;
+}
+
+// Cancels the job 'id' of 'client' (all jobs of the client if 'id' is empty). A queued job is
+// removed, and a running job is interrupted (its result is sent by the worker).
+void SolverDaemon::cancel(Client *client, const string& id, bool reply) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool found = false;
+    auto match = [&](const std::shared_ptr<Job>& job) {
+        return job && job->client.get() == client && (id.empty() || job->id == id);
+    };
+    for (auto it = queue.begin(); it != queue.end(); ) {
+        if (match(*it)) {
+            if (reply) client->send("result " + (*it)->id + " CANCELLED");
+            it = queue.erase(it);
+            found = true;
+        } else
+            ++it;
+    }
+    for (Worker *w : workers)
+        if (match(w->job)) {
+            w->job->cancelled = true;
+            w->dps.interrupt();
+            found = true;
+        }
+    if (!found && reply)
+        client->send("error " + id + " no such job");
+}
+
+bool SolverDaemon::hasJobs(Client *client) {
+    for (auto& job : queue)
+        if (job->client.get() == client) return true;
+    for (Worker *w : workers)
+        if (w->job && w->job->client.get() == client) return true;
+    return false;
+}
+
+// Stops accepting connections and jobs, and cancels all jobs.
+void SolverDaemon::stop() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping) return;
+    stopping = true;
+    for (auto& job : queue)
+        job->client->send("result " + job->id + " CANCELLED");
+    queue.clear();
+    for (Worker *w : workers)
+        if (w->job) {
+            w->job->cancelled = true;
+            w->dps.interrupt();
+        }
+    queued_cv.notify_all();
+    shutdown(listen_fd, SHUT_RDWR);    // wakes up accept()
+}
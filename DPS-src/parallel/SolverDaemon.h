@@ -0,0 +1,115 @@
+#ifndef _DPS_SOLVER_DAEMON_H_
+#define _DPS_SOLVER_DAEMON_H_
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <atomic>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "Options.h"
+#include "DetParallelSolver.h"
+
+namespace DPS {
+
+using std::string;
+using std::vector;
+
+// Serves solving jobs on a unix domain socket (the 'daemon' option). The threads are divided among
+// 'daemon-jobs' workers spawned at the start, and each worker solves jobs one by one by its
+// DetParallelSolver of which threads are kept across jobs. Queued jobs are taken in the order of
+// priorities (then in the order of arrivals).
+//
+// A client sends requests in lines, and the replies of its jobs are sent to its connection:
+//   solve <id> [prio=N] [time=S] [conflicts=N] [progress=S] [model=1] [file=PATH] [-- <options>]
+//       queues a job. The clauses are read from PATH, or the DIMACS lines following the request up
+//       to a line 'end'. 'time' and 'conflicts' are the limits of SolveLimits, the options are
+//       those of the command line (appended to the options of the daemon), and a progress line is
+//       sent every 'progress' seconds.
+//   cancel <id>    removes the queued job or interrupts the running job
+//   status         replies the numbers of jobs
+//   shutdown       cancels all jobs and stops the daemon
+// Replies:
+//   queued <id>
+//   started <id>
+//   progress <id> time=<s> conflicts=<n> confs/s=<n>
+//   result <id> <SAT|UNSAT|UNKNOWN|CANCELLED> time=<s> vars=<n> clauses=<n> conflicts=<n> [winner=<thread> period=<n>]
+//       followed by the model in 'v' lines if SAT and model=1
+//   error <id> <message>
+//   status queued=<n> running=<n> done=<n>
+// Job ids are those of the connection. The replies are sent after the client shuts down its writing
+// side, while the jobs of a closed connection are cancelled.
+// The socket is created with mode 0600, so only the user running the daemon can connect. Every
+// client that can connect is trusted as much as that user: it can submit jobs reading any file
+// the daemon can read, and 'shutdown' stops the daemon.
+class SolverDaemon {
+private:
+    struct Client {
+        int         fd;
+        std::mutex  mutex;          // serializes the replies
+        bool        closed;
+        std::atomic<bool> broken;   // a reply could not be sent
+        string      buf;            // received bytes not yet read as lines
+        Client(int _fd) : fd(_fd), closed(false), broken(false) {}
+        void send(const string& msg);
+        bool readLine(string& line);
+    };
+    struct Job {
+        string            id;
+        int               prio;
+        uint64_t          seq;      // order of arrivals
+        Options           options;
+        SolveLimits       limits;
+        uint32_t          progress; // interval of progress lines [s] (0 for none)
+        bool              model;
+        vector<int>       lits;     // 0-terminated clauses given inline
+        std::shared_ptr<Client> client;
+        std::atomic<bool> cancelled;
+        Job() : prio(0), seq(0), progress(0), model(false), cancelled(false) {}
+    };
+    struct Worker {
+        DetParallelSolver     dps;
+        std::shared_ptr<Job>  job;  // running job (nullptr if idle)
+        std::thread           thread;
+    };
+
+    Options         options;        // options of the daemon
+    string          path;           // path of the socket
+    uint32_t        num_jobs;
+    uint32_t        job_threads;    // # of threads of each worker
+    double          job_mem_lim;    // memory limit of each worker (0 for unlimited)
+    int             listen_fd;
+
+    std::mutex                          mutex;
+    std::condition_variable             queued_cv;      // a job is queued or the daemon stops
+    std::condition_variable             clients_cv;     // a client is disconnected or a job is done
+    vector<std::shared_ptr<Job>>        queue;
+    vector<Worker*>                     workers;
+    vector<std::shared_ptr<Client>>     clients;
+    uint64_t                            num_arrivals;
+    uint64_t                            num_done;
+    bool                                stopping;
+
+    void   runWorker(Worker *w);
+    string solveJob(DetParallelSolver& dps, Job& job);
+    void   serveClient(std::shared_ptr<Client> client);
+    std::shared_ptr<Job> parseJob(std::shared_ptr<Client> client, const vector<string>& words);
+    void   cancel(Client *client, const string& id, bool reply);
+    bool   hasJobs(Client *client);
+    void   stop();
+
+public:
+    // throws std::runtime_error if the socket can not be created
+    SolverDaemon(const Options& options);
+    ~SolverDaemon();
+
+    // serves jobs until the 'shutdown' request (returns the exit status)
+    int run();
+};
+
+}
+
+#endif
@@ -1,63 +1,88 @@
+#include <cassert>
+
 #include "ClauseBuffer.h"
 
 namespace DPS {
 
-void ClauseBuffer::addClause(const Clause& c, uint32_t val) {
-    // 'val' is a new key
-    if (keys.find(val) == keys.end()) 
-        keys.insert(val);
-    db[val].push_back(c);
+int* ClauseBuffer::reserve(uint32_t val, uint32_t size) {
+    assert(reserved == nullptr);
+    reserved = &db[val];
+    std::vector<int>& lits = reserved->lits;
+    size_t begin = lits.size();
+    lits.resize(begin + size);
+    return lits.data() + begin;
+}
+
+void ClauseBuffer::commit() {
+    assert(reserved != nullptr);
+    uint32_t begin = reserved->ends.empty() ? 0 : reserved->ends.back();
+    reserved->ends.push_back(reserved->lits.size());
     num_clauses++;
-    num_literals += c.size();
+    num_literals += reserved->lits.size() - begin;
+    reserved = nullptr;
+}
+
+void ClauseBuffer::addClause(const Clause& c, uint32_t val) {
+    std::copy(c.begin(), c.end(), reserve(val, c.size()));
+    commit();
 }
 
 uint32_t ClauseBuffer::exportTo(PrdClauses& dest, uint32_t max_lits) {
+    assert(reserved == nullptr);
     uint32_t exported_literals = 0;
     uint32_t exported_clauses = 0;
     bool full = false;
-    auto it = keys.begin();
-    while (it != keys.end()) {
-        std::deque<Clause>& queue = db[*it];
-        while (!queue.empty()) {
-            Clause& c = queue.front();
-            dest.addClause(c);
-            exported_literals += c.size();
+    for (auto& kv : db) {
+        Bucket& bucket = kv.second;
+        while (!bucket.empty()) {
+            uint32_t begin = bucket.head == 0 ? 0 : bucket.ends[bucket.head - 1];
+            uint32_t size  = bucket.ends[bucket.head] - begin;
+            dest.addClause(bucket.lits.data() + begin, size);
+            exported_literals += size;
             exported_clauses++;
-            num_literals -= c.size();
+            num_literals -= size;
             num_clauses--;
-            queue.pop_front();
+            bucket.head++;
             // If max_lits == 0, it means unlimit. 
             if (0 < max_lits && max_lits < exported_literals) { 
                 full = true;
                 break;
             }
         }
-        if (full) break;
-        // if queue is a empty, then the key is removed.
-        if (queue.empty()) {
-            db.erase(*it);
-            keys.erase(it++);
+        // buckets are reused (keeping their capacity) once all clauses are exported,
+        // otherwise the exported prefix is dropped if it is the larger part
+        if (bucket.empty()) {
+            bucket.lits.clear();
+            bucket.ends.clear();
+            bucket.head = 0;
+        }
+        else if (bucket.head * 2 > bucket.ends.size()) {
+            uint32_t offset = bucket.ends[bucket.head - 1];
+            bucket.lits.erase(bucket.lits.begin(), bucket.lits.begin() + offset);
+            bucket.ends.erase(bucket.ends.begin(), bucket.ends.begin() + bucket.head);
+            for (uint32_t& e : bucket.ends) e -= offset;
+            bucket.head = 0;
         }
-        else
-            ++it;
+        if (full) break;
     }
 
     return exported_clauses;
 }
 
 std::ostream & operator << (std::ostream& stream, const ClauseBuffer& buf) {
-    auto i = buf.keys.begin();
-    while (i != buf.keys.end()) {
-        stream << "Key " << *i << std::endl;
-        const std::deque<Clause>& queue = buf.db.at(*i);
-        auto j = queue.begin();
-        while (j != queue.end()) {
-            stream << "  " << *j << std::endl;
-            ++j;
+    for (const auto& kv : buf.db) {
+        const ClauseBuffer::Bucket& bucket = kv.second;
+        if (bucket.empty()) continue;
+        stream << "Key " << kv.first << std::endl;
+        for (size_t i = bucket.head; i < bucket.ends.size(); i++) {
+            uint32_t begin = i == 0 ? 0 : bucket.ends[i - 1];
+            stream << " ";
+            for (uint32_t j = begin; j < bucket.ends[i]; j++)
+                stream << " " << bucket.lits[j];
+            stream << std::endl;
         }
-        ++i;
     }
     return stream;
 }
 
-}
\ No newline at end of file
+}
@@ -2,24 +2,41 @@
 #define _DPS_CLAUSE_BUFFER_H_
 
 #include <iostream>
-#include <unordered_map>
-#include <deque>
-#include <set>
+#include <vector>
+#include <map>
 
 #include "../sat/Clause.h"
 #include "PrdClauses.h"
 
 namespace DPS {
 
+// Staging area of exported clauses of a thread. Clauses are kept in buckets ordered by their
+// keys (clause sizes) and are exported to period buffers from the smallest key.
+// Base solvers write literals directly into the buffer by reserve() and commit(), so each
+// exported clause is copied only once more (into the period buffer).
 class ClauseBuffer {
 private:
-    std::unordered_map<uint32_t, std::deque<Clause>> db;
-    std::set<uint32_t> keys;
+    struct Bucket {
+        std::vector<int>      lits;     // literals of clauses
+        std::vector<uint32_t> ends;     // end position of each clause in 'lits'
+        size_t                head;     // index of the first clause not yet exported
+        Bucket() : head(0) {}
+        bool empty() const { return head == ends.size(); }
+    };
+    std::map<uint32_t, Bucket> db;
+    Bucket  *reserved;                  // bucket of the reserved clause (nullptr if none)
     uint32_t num_clauses;
     uint64_t num_literals;
 
 public:
-    ClauseBuffer() : num_clauses(0), num_literals(0) {}
+    ClauseBuffer() : reserved(nullptr), num_clauses(0), num_literals(0) {}
+
+    // returns the space for 'size' literals of a clause with the key 'val',
+    // which is valid until commit() is called
+    int* reserve(uint32_t val, uint32_t size);
+    // adds the reserved clause
+    void commit();
+
     void addClause(const Clause& c, uint32_t val);
     uint32_t exportTo(PrdClauses& dest, uint32_t max_lits);
     
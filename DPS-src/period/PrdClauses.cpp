@@ -1,6 +1,7 @@
 #include <assert.h>
 
 #include "PrdClauses.h"
+#include "../utils/SchedNoise.h"
 
 using namespace DPS;
 
@@ -8,7 +9,7 @@ PrdClauses::PrdClauses(int thread_id, uint64_t period) :
         thn(thread_id),
         prd(period),
         prd_len(0),
-        num_literals(0),
+        offsets(1, 0),
         num_exported_threads(0),
         completed(false)
 {
@@ -17,11 +18,10 @@ PrdClauses::PrdClauses(int thread_id, uint64_t period) :
     pthread_cond_init(&is_completed, NULL);
 }
 
-bool PrdClauses::addClause(const Clause& c) {
+void PrdClauses::addClause(const int *lits, uint32_t size) {
     assert(!completed);
-    clauses.push_back(c);
-    num_literals += c.size();
-    return true;
+    literals.insert(literals.end(), lits, lits + size);
+    offsets.push_back(literals.size());
 }
 
 // When the period of the thread is finished (it means that the addition of clauses is completed),
@@ -38,9 +38,11 @@ void PrdClauses::completeAddition(uint64_t _prd_len) {
 
 // Wait the addition of clauses to be completed.
 void PrdClauses::waitAdditionCompleted(void) {
+    SchedNoise::inject(SchedNoise::WaitAddition);
     pthread_mutex_lock(&lock_completed);
-    if (!completed)
+    while (!completed)      // against spurious wakeups
         pthread_cond_wait(&is_completed, &lock_completed);
+    SchedNoise::inject(SchedNoise::WaitAddition);     // holds up the other waiters as well
     pthread_mutex_unlock(&lock_completed);
 }
 
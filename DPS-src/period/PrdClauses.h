@@ -15,8 +15,8 @@ private:
     int thn;                            // thread number
     uint64_t prd;                       // period number
     uint64_t prd_len;                   // period length for adaptive strategy
-    size_t   num_literals;              // the number of literals
-    std::vector<Clause> clauses;        // a set of literals
+    std::vector<int>      literals;     // literals of all clauses
+    std::vector<uint32_t> offsets;      // the i-th clause consists of literals[offsets[i]] ... literals[offsets[i+1]-1]
 
     int num_exported_threads;           // the number of threads to which these clauses are exported.
     pthread_mutex_t lock_num_exported_threads;    // mutex on the variable "num_exported_threads"
@@ -28,7 +28,7 @@ private:
 public:
     PrdClauses(int thread_id, uint64_t period);
 
-    bool addClause(const Clause& c);
+    void addClause(const int *lits, uint32_t size);
 
     // When the period of the thread is finished (it means that the addition of clauses is completed),
     // then this method is called by the thread. This method notifies waiting threads to be completed.
@@ -39,8 +39,8 @@ public:
     bool isAdditionCompleted(void);
 
     // Methods for exportation
-    int size(void) const { return clauses.size(); };
-    const Clause& operator [] (int index) const { return clauses[index]; }
+    int size(void) const { return offsets.size() - 1; };
+    ClauseView operator [] (int index) const { return ClauseView(literals.data() + offsets[index], literals.data() + offsets[index+1]); }
 
     // When exporting to the specified thread is finished, then this method is called.
     void completeExportation(int thread_id);
@@ -49,8 +49,8 @@ public:
     // Misc
     uint64_t  period(void)          const { return prd; }
     uint64_t  getPrdLenCand(void)   const { return prd_len; }
-    uint32_t  getNumClauses(void)   const { return clauses.size(); }
-    uint32_t  getNumLiterals(void)  const { return num_literals; }
+    uint32_t  getNumClauses(void)   const { return offsets.size() - 1; }
+    uint32_t  getNumLiterals(void)  const { return literals.size(); }
 };
 
 }
@@ -8,6 +8,8 @@ PrdClausesQueue::PrdClausesQueue(int _thn, int _num_threads) :
     thn(_thn)
 ,   num_threads(_num_threads)
 ,   next_period(std::vector<uint64_t>(_num_threads))
+,   retired(false)
+,   retired_from(0)
 {
     pthread_rwlock_init(&rwlock, NULL);
 
@@ -19,6 +21,8 @@ PrdClausesQueue::PrdClausesQueue(int _thn, int _num_threads) :
 
 PrdClausesQueue::~PrdClausesQueue()
 {
+    for (PrdClauses *pcs : queue)
+        delete pcs;
     queue.clear();
 }
 
@@ -67,7 +71,7 @@ PrdClauses* PrdClausesQueue::get(int thread, uint64_t period) {
 
     pthread_rwlock_rdlock(&rwlock);
 
-    if (queue.size() == 0 || p < queue.front()->period())  {
+    if (queue.size() == 0 || p < queue.front()->period() || (retired && p >= retired_from))  {
         pthread_rwlock_unlock(&rwlock);
         return NULL;
     }
@@ -83,6 +87,25 @@ PrdClauses* PrdClausesQueue::get(int thread, uint64_t period) {
     return prdClauses;
 }
 
+// When the thread finishes its work while the others continue, then this method is called.
+void PrdClausesQueue::retire() {
+    pthread_rwlock_wrlock(&rwlock);
+    PrdClauses& last = *queue.back();
+    retired      = true;
+    retired_from = last.period();
+    pthread_rwlock_unlock(&rwlock);
+
+    // wakes up the threads waiting for the period (they check isRetired)
+    last.completeAddition(0);
+}
+
+bool PrdClausesQueue::isRetired(uint64_t period) {
+    pthread_rwlock_rdlock(&rwlock);
+    bool ret = retired && period >= retired_from;
+    pthread_rwlock_unlock(&rwlock);
+    return ret;
+}
+
 // Get a set of clauses which are generated at the specified period.
 PrdClauses* PrdClausesQueue::get(uint64_t period) {
     assert(queue.front()->period() <= period);
@@ -14,6 +14,8 @@ private:
     std::vector<uint64_t>     next_period;  // the next period for exporting to the specified thread
     std::vector<PrdClauses *> queue;        // a list of sets of clauses.
     pthread_rwlock_t          rwlock;       // read/write lock of this object.
+    bool                      retired;      // the thread adds no more clauses (see retire)
+    uint64_t                  retired_from; // the first period that the retired thread did not complete
     
 public:
     PrdClausesQueue(int thread_id, int nb_threads);
@@ -32,6 +34,12 @@ public:
     // Get a set of own clauses which are generated at the specified period.
     PrdClauses* get(uint64_t period);
 
+    // When the thread finishes its work while the others continue (the cube mode), then this method
+    // is called after the last period is completed. The other threads do not wait for the following
+    // periods, and import nothing from them.
+    void retire();
+    bool isRetired(uint64_t period);
+
     // Return the last set of clauses
     PrdClauses& last() { assert(queue.size() > 0); return *queue[queue.size() - 1]; }
     
@@ -8,6 +8,18 @@ namespace DPS {
 
 typedef std::vector<int> Clause;     // A Clause in DPS is a vector of int
 
+// A read-only view of a clause stored in a flat literal array (e.g., Instance and PrdClauses)
+class ClauseView {
+    const int *b;
+    const int *e;
+public:
+    ClauseView(const int *_b, const int *_e) : b(_b), e(_e) {}
+    const int* begin()                const { return b; }
+    const int* end()                  const { return e; }
+    size_t     size()                 const { return e - b; }
+    int        operator[](size_t i)   const { return b[i]; }
+};
+
 std::ostream & operator << (std::ostream& stream, const Clause& c);
 
 }
@@ -0,0 +1,256 @@
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+#ifdef DPS_USE_LZMA
+#include <lzma.h>
+#endif
+#ifdef DPS_USE_BZIP2
+#include <bzlib.h>
+#endif
+#ifdef DPS_USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "InputDecoder.h"
+
+namespace DPS {
+
+static const size_t IN_BUF_SIZE = 1 << 17;     // 128 KB of compressed input per read
+
+//=================================================================================================
+// gzip (zlib also reads uncompressed files transparently)
+
+class GzipDecoder : public InputDecoder {
+    gzFile in;
+    const char* fmt;
+public:
+    GzipDecoder(const std::string& filename, const char* _fmt) : fmt(_fmt) {
+        in = gzopen(filename.c_str(), "rb");
+        if (in == Z_NULL)
+            throw std::invalid_argument("gzopen error: " + filename);
+        gzbuffer(in, IN_BUF_SIZE);
+    }
+    ~GzipDecoder() { gzclose(in); }
+
+    size_t read(char *buf, size_t len) {
+        int n = gzread(in, buf, (unsigned)len);
+        if (n < 0) throw std::runtime_error("gzread error");
+        return n;
+    }
+    const char* name() const { return fmt; }
+};
+
+//=================================================================================================
+// xz (multi-threaded if the file consists of several blocks)
+
+#ifdef DPS_USE_LZMA
+class XzDecoder : public InputDecoder {
+    FILE*             in;
+    lzma_stream       strm;
+    std::vector<char> in_buf;
+    bool              eof;
+public:
+    XzDecoder(FILE *fp, uint32_t num_threads) : in(fp), strm(LZMA_STREAM_INIT), in_buf(IN_BUF_SIZE), eof(false) {
+        lzma_ret ret;
+#if LZMA_VERSION >= 50040000
+        lzma_mt mt;
+        memset(&mt, 0, sizeof(mt));
+        mt.flags              = LZMA_CONCATENATED;
+        mt.threads            = num_threads > 0 ? num_threads : 1;
+        mt.memlimit_threading = UINT64_MAX;
+        mt.memlimit_stop      = UINT64_MAX;
+        ret = lzma_stream_decoder_mt(&strm, &mt);
+#else
+        (void)num_threads;
+        ret = lzma_stream_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED);
+#endif
+        if (ret != LZMA_OK) {
+            fclose(in);
+            throw std::runtime_error("lzma_stream_decoder error");
+        }
+    }
+    ~XzDecoder() { lzma_end(&strm); fclose(in); }
+
+    size_t read(char *buf, size_t len) {
+        strm.next_out  = (uint8_t*)buf;
+        strm.avail_out = len;
+        while (strm.avail_out > 0) {
+            lzma_action action = LZMA_RUN;
+            if (strm.avail_in == 0) {
+                if (!eof) {
+                    strm.next_in  = (const uint8_t*)in_buf.data();
+                    strm.avail_in = fread(in_buf.data(), 1, in_buf.size(), in);
+                    if (ferror(in)) throw std::runtime_error("xz read error");
+                    eof = feof(in);
+                }
+                if (eof) action = LZMA_FINISH;
+            }
+            lzma_ret ret = lzma_code(&strm, action);
+            if (ret == LZMA_STREAM_END) break;
+            if (ret != LZMA_OK) throw std::runtime_error("xz decode error");
+        }
+        return len - strm.avail_out;
+    }
+    const char* name() const { return "xz"; }
+};
+#endif
+
+//=================================================================================================
+// bzip2 (concatenated streams produced by pbzip2 are supported)
+
+#ifdef DPS_USE_BZIP2
+class Bzip2Decoder : public InputDecoder {
+    FILE*   in;
+    BZFILE* bz;
+    bool    end;
+public:
+    Bzip2Decoder(FILE *fp) : in(fp), bz(nullptr), end(false) {
+        reopen(nullptr, 0);
+    }
+    ~Bzip2Decoder() {
+        int err;
+        if (bz) BZ2_bzReadClose(&err, bz);
+        fclose(in);
+    }
+
+    void reopen(void *unused, int num_unused) {
+        int err;
+        bz = BZ2_bzReadOpen(&err, in, 0, 0, unused, num_unused);
+        if (err != BZ_OK) throw std::runtime_error("BZ2_bzReadOpen error");
+    }
+
+    size_t read(char *buf, size_t len) {
+        size_t total = 0;
+        while (!end && total < len) {
+            int err;
+            int n = BZ2_bzRead(&err, bz, buf + total, (int)(len - total));
+            if (err != BZ_OK && err != BZ_STREAM_END) throw std::runtime_error("bzip2 decode error");
+            total += n;
+            if (err == BZ_STREAM_END) {
+                // Continue with the next stream if the file has remaining bytes
+                void *unused; int num_unused;
+                BZ2_bzReadGetUnused(&err, bz, &unused, &num_unused);
+                std::vector<char> rest((char*)unused, (char*)unused + num_unused);
+                BZ2_bzReadClose(&err, bz);
+                bz = nullptr;
+                int c = rest.empty() ? fgetc(in) : EOF;
+                if (rest.empty() && c == EOF)
+                    end = true;
+                else {
+                    if (c != EOF) ungetc(c, in);
+                    reopen(rest.data(), rest.size());
+                }
+            }
+        }
+        return total;
+    }
+    const char* name() const { return "bzip2"; }
+};
+#endif
+
+//=================================================================================================
+// zstd
+
+#ifdef DPS_USE_ZSTD
+class ZstdDecoder : public InputDecoder {
+    FILE*             in;
+    ZSTD_DCtx*        dctx;
+    std::vector<char> in_buf;
+    ZSTD_inBuffer     input;
+    bool              eof;
+    size_t            last_ret;     // 0 if the last frame is complete
+public:
+    ZstdDecoder(FILE *fp) : in(fp), dctx(ZSTD_createDCtx()), in_buf(ZSTD_DStreamInSize()), eof(false), last_ret(0) {
+        if (!dctx) {
+            fclose(in);
+            throw std::runtime_error("could not allocate memory for ZSTD_DCtx");
+        }
+        input.src  = in_buf.data();
+        input.size = 0;
+        input.pos  = 0;
+    }
+    ~ZstdDecoder() { ZSTD_freeDCtx(dctx); fclose(in); }
+
+    size_t read(char *buf, size_t len) {
+        ZSTD_outBuffer output = { buf, len, 0 };
+        while (output.pos < output.size) {
+            if (input.pos == input.size && !eof) {
+                input.size = fread(in_buf.data(), 1, in_buf.size(), in);
+                input.pos  = 0;
+                if (ferror(in)) throw std::runtime_error("zstd read error");
+                eof = feof(in);
+            }
+            size_t in_before = input.pos, out_before = output.pos;
+            size_t ret = ZSTD_decompressStream(dctx, &output, &input);
+            if (ZSTD_isError(ret)) throw std::runtime_error(std::string("zstd decode error: ") + ZSTD_getErrorName(ret));
+            bool progress = input.pos != in_before || output.pos != out_before;
+            if (progress) last_ret = ret;
+            else if (eof && input.pos == input.size) {
+                // all input is consumed and flushed, so a frame in progress is truncated
+                if (last_ret != 0) throw std::runtime_error("zstd decode error: truncated input");
+                break;
+            }
+        }
+        return output.pos;
+    }
+    const char* name() const { return "zstd"; }
+};
+#endif
+
+//=================================================================================================
+
+InputDecoder* InputDecoder::open(const std::string& filename, uint32_t num_threads) {
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (fp == nullptr)
+        throw std::invalid_argument("could not open: " + filename);
+    unsigned char magic[6] = { 0 };
+    size_t n = fread(magic, 1, sizeof(magic), fp);
+    rewind(fp);
+
+    (void)num_threads;
+    if (n >= 6 && memcmp(magic, "\xFD" "7zXZ\x00", 6) == 0) {
+#ifdef DPS_USE_LZMA
+        return new XzDecoder(fp, num_threads);
+#else
+        fclose(fp);
+        throw std::invalid_argument("xz format is not supported by this build: " + filename);
+#endif
+    }
+    if (n >= 3 && memcmp(magic, "BZh", 3) == 0) {
+#ifdef DPS_USE_BZIP2
+        return new Bzip2Decoder(fp);
+#else
+        fclose(fp);
+        throw std::invalid_argument("bzip2 format is not supported by this build: " + filename);
+#endif
+    }
+    if (n >= 4 && memcmp(magic, "\x28\xB5\x2F\xFD", 4) == 0) {
+#ifdef DPS_USE_ZSTD
+        return new ZstdDecoder(fp);
+#else
+        fclose(fp);
+        throw std::invalid_argument("zstd format is not supported by this build: " + filename);
+#endif
+    }
+    fclose(fp);
+    bool gzip = n >= 2 && magic[0] == 0x1F && magic[1] == 0x8B;
+    return new GzipDecoder(filename, gzip ? "gzip" : "plain");
+}
+
+std::string InputDecoder::supportedFormats() {
+    std::string formats = "plain,gzip";
+#ifdef DPS_USE_LZMA
+    formats += ",xz";
+#endif
+#ifdef DPS_USE_BZIP2
+    formats += ",bzip2";
+#endif
+#ifdef DPS_USE_ZSTD
+    formats += ",zstd";
+#endif
+    return formats;
+}
+
+}
@@ -0,0 +1,31 @@
+#ifndef _DPS_INPUT_DECODER_H_
+#define _DPS_INPUT_DECODER_H_
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace DPS {
+
+// An input decoder converts a (possibly compressed) file into a plain byte stream.
+// The concrete decoder is selected by the magic bytes at the head of the file.
+class InputDecoder {
+public:
+    virtual ~InputDecoder() {}
+
+    // Read at most 'len' decoded bytes into 'buf'. Returns 0 at the end of the stream.
+    virtual size_t read(char *buf, size_t len) = 0;
+    // Name of the format (for log output)
+    virtual const char* name() const = 0;
+
+    // Open 'filename' and return a decoder suitable for its format.
+    // 'num_threads' is a hint for decoders that can decode independent blocks in parallel.
+    static InputDecoder* open(const std::string& filename, uint32_t num_threads = 1);
+
+    // Comma separated list of supported formats (depends on build options)
+    static std::string supportedFormats();
+};
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include <stdexcept>
+
+#include "InputStream.h"
+
+namespace DPS {
+
+InputStream::InputStream(const std::string& filename, uint32_t decode_threads, size_t chunk_size, size_t num_chunks) :
+    decoder(InputDecoder::open(filename, decode_threads))
+,   chunks(num_chunks)
+,   head(0)
+,   tail(0)
+,   num_filled(0)
+,   finished(false)
+,   cancelled(false)
+,   pos(nullptr)
+,   end(nullptr)
+,   holding(false)
+{
+    for (Chunk& c : chunks)
+        c.data.resize(chunk_size);
+    worker = std::thread(&InputStream::decode, this);
+}
+
+InputStream::~InputStream() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        cancelled = true;
+    }
+    not_full.notify_all();
+    worker.join();
+    delete decoder;
+}
+
+// Body of the decoder thread
+void InputStream::decode() {
+    try {
+        while (true) {
+            Chunk *chunk;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                not_full.wait(lock, [this] { return num_filled < chunks.size() || cancelled; });
+                if (cancelled) return;
+                chunk = &chunks[tail];
+            }
+            // decode outside the lock
+            chunk->size = decoder->read(chunk->data.data(), chunk->data.size());
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (chunk->size == 0) {
+                    finished = true;
+                    not_empty.notify_one();
+                    return;
+                }
+                tail = (tail + 1) % chunks.size();
+                num_filled++;
+            }
+            not_empty.notify_one();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mtx);
+        error    = std::current_exception();
+        finished = true;
+        not_empty.notify_one();
+    }
+}
+
+// Release the consumed chunk and wait for the next one
+int InputStream::refill() {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (holding) {
+        head = (head + 1) % chunks.size();
+        num_filled--;
+        holding = false;
+        not_full.notify_one();
+    }
+    not_empty.wait(lock, [this] { return num_filled > 0 || finished; });
+    if (num_filled == 0) {
+        pos = end = nullptr;
+        if (error) std::rethrow_exception(error);
+        return EOF;
+    }
+    holding = true;
+    Chunk& chunk = chunks[head];
+    pos = chunk.data.data();
+    end = pos + chunk.size;
+    return (unsigned char)*pos++;
+}
+
+}
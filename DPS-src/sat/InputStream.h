@@ -0,0 +1,61 @@
+#ifndef _DPS_INPUT_STREAM_H_
+#define _DPS_INPUT_STREAM_H_
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdio>
+
+#include "InputDecoder.h"
+
+namespace DPS {
+
+// A character stream whose content is decoded by a separate thread.
+// The decoder thread and the parser are connected by a bounded buffer of chunks,
+// so decompression and parsing are pipelined.
+class InputStream {
+private:
+    struct Chunk {
+        std::vector<char> data;
+        size_t            size;
+        Chunk() : size(0) {}
+    };
+
+    InputDecoder*           decoder;
+    std::vector<Chunk>      chunks;        // ring buffer of chunks
+    size_t                  head;          // next chunk to be consumed
+    size_t                  tail;          // next chunk to be filled
+    size_t                  num_filled;    // # of filled chunks in the ring buffer
+    bool                    finished;      // decoder reached the end of the stream
+    std::exception_ptr      error;         // exception thrown in the decoder thread
+    bool                    cancelled;
+    std::mutex              mtx;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::thread             worker;
+
+    // current chunk being parsed
+    const char*             pos;
+    const char*             end;
+    bool                    holding;       // whether the parser holds the chunk at 'head'
+
+    void decode();
+    int  refill();
+
+public:
+    InputStream(const std::string& filename, uint32_t decode_threads = 1,
+                size_t chunk_size = 1 << 20, size_t num_chunks = 4);
+    ~InputStream();
+
+    // Return the next character or EOF
+    int get() { return pos < end ? (unsigned char)*pos++ : refill(); }
+
+    const char* format() const { return decoder->name(); }
+};
+
+}
+
+#endif
@@ -3,30 +3,41 @@
 #include <stdexcept>
 #include <cctype>
 #include <cassert>
-#include <zlib.h>
+#include <cstdio>
 
 #include "Instance.h"
+#include "InputStream.h"
 
 using std::vector;
 
 namespace DPS {
 
-Instance Instance::loadFormula(const std::string& filename) {
-	gzFile in = gzopen(filename.c_str(), "rb");
-    if (in == Z_NULL) 
-		throw std::invalid_argument("gzopen error: " + filename);
+Instance Instance::loadFormula(const std::string& filename, uint32_t decode_threads) {
+	// decompression is done by another thread (see InputStream)
+	InputStream in(filename, decode_threads);
 
 	Instance instance;
-    Clause clause;
-	int max_var = 0;
 	bool neg = false;
 	int c;
-    while ((c = gzgetc(in)) != EOF) {
- 		// comment or problem definition line
- 		if (c == 'c' || c == 'p') {
+    while ((c = in.get()) != EOF) {
+ 		// problem definition line
+ 		if (c == 'p') {
+			// reserve the literal array by the header 'p cnf <vars> <clauses>'
+			std::string line;
+ 			while(c != '\n' && c != EOF) {
+				line.push_back(c);
+                c = in.get();
+			}
+			unsigned long vars = 0, clauses = 0;
+			if (sscanf(line.c_str(), "p cnf %lu %lu", &vars, &clauses) == 2)
+				instance.offsets.reserve(clauses + 1);
+ 			continue;
+ 		}
+ 		// comment line
+ 		if (c == 'c') {
  			// skip this line
- 			while(c != '\n') 
-                c = gzgetc(in);
+ 			while(c != '\n' && c != EOF) 
+                c = in.get();
  			continue;
  		}
  		// whitespace
@@ -39,29 +50,23 @@ Instance Instance::loadFormula(const std::string& filename) {
 		// number
 		if (isdigit(c)) {
 			int num = c - '0';
-			c = gzgetc(in);
+			c = in.get();
 			while (isdigit(c)) {
 				num = num * 10 + (c - '0');
-				c = gzgetc(in);
+				c = in.get();
 			}
 			if (neg) {
                 num = -num;
 				neg = false;
 			}
 			if (num != 0) {
-				clause.push_back(num);
-				max_var = std::max(max_var, std::abs(num));				
+				instance.addLiteral(num);
                 continue;
 			} 
-            instance.push_back(clause);
-			instance.num_clauses++;
-			instance.tot_literals += clause.size();
-            clause.clear();
+			instance.closeClause();
 		}
 	}
-	instance.num_vars = max_var;
 
- 	gzclose(in);	
 	return instance;
 }
 
@@ -3,38 +3,82 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cstdlib>
 
 #include "../sat/Clause.h"
 
 namespace DPS {
 
-class Instance : private std::vector<Clause> {      // because STL classes have no virtual destructor
+// All clauses are stored in one literal array. The i-th clause consists of
+// literals[offsets[i]] ... literals[offsets[i+1]-1].
+class Instance {
 protected:
-    uint64_t num_vars;
-    uint64_t num_clauses;
-    uint64_t tot_literals;
+    uint64_t              num_vars;
+    uint64_t              num_clauses;
+    uint64_t              tot_literals;
+    std::vector<int>      literals;
+    std::vector<uint64_t> offsets;
 
 public:
+    class const_iterator {
+        const Instance *ins;
+        uint64_t        idx;
+    public:
+        const_iterator(const Instance *_ins, uint64_t _idx) : ins(_ins), idx(_idx) {}
+        ClauseView      operator*()                              const { return (*ins)[idx]; }
+        const_iterator& operator++()                                   { idx++; return *this; }
+        bool            operator!=(const const_iterator& other)  const { return idx != other.idx; }
+        bool            operator==(const const_iterator& other)  const { return idx == other.idx; }
+    };
+
     // default constructor
-    Instance() : vector(), num_vars(0), num_clauses(0), tot_literals(0) {}
+    Instance() : num_vars(0), num_clauses(0), tot_literals(0), offsets(1, 0) {}
     Instance(const Instance&) = default;            // copy constructor
     Instance& operator=(const Instance&) = default; // copy assignment operator
     Instance(Instance&&) = default;                 // move constructor
     Instance& operator=(Instance&&) = default;      // move aissgnment operator
 
-    static Instance loadFormula(const std::string& filename);
+    static Instance loadFormula(const std::string& filename, uint32_t decode_threads = 1);
+
+    void addClause(const Clause& c) { for (int lit : c) addLiteral(lit); closeClause(); }
+    void addClause(const int *lits, size_t size) { for (size_t i = 0; i < size; i++) addLiteral(lits[i]); closeClause(); }
+    // adds the clauses in 'lits[0] ... lits[num_lits-1]', each of which is terminated by 0 as in
+    // DIMACS (literals after the last 0 are ignored), and returns the # of added clauses
+    uint64_t addClauses(const int *lits, size_t num_lits) {
+        uint64_t n = 0;
+        size_t   b = 0;
+        literals.reserve(literals.size() + num_lits);
+        for (size_t i = 0; i < num_lits; i++)
+            if (lits[i] == 0) { addClause(lits + b, i - b); b = i + 1; n++; }
+        return n;
+    }
+    void addLiteral(int lit) {
+        literals.push_back(lit);
+        uint64_t var = std::abs(lit);
+        if (num_vars < var) num_vars = var;
+    }
+    void closeClause() {
+        offsets.push_back(literals.size());
+        num_clauses++;
+        tot_literals = literals.size();
+    }
 
     uint64_t getNumVars()       const { return num_vars; }
     uint64_t getNumClauses()    const { return num_clauses; }
     uint64_t getTotalLiterals() const { return tot_literals; }
 
+    // flat representation for bulk loading
+    const int*      getLiterals()   const { return literals.data(); }
+    const uint64_t* getOffsets()    const { return offsets.data(); }
+
     // provide some vector interfaces
-    using vector::size;
-    using vector::operator[];
-    using vector::begin;
-    using vector::end;
+    size_t          size()                const { return num_clauses; }
+    ClauseView      operator[](size_t i)  const { return ClauseView(literals.data() + offsets[i], literals.data() + offsets[i+1]); }
+    const_iterator  begin()               const { return const_iterator(this, 0); }
+    const_iterator  end()                 const { return const_iterator(this, num_clauses); }
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
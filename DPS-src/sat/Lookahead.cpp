@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+
+#include "Lookahead.h"
+
+using namespace DPS;
+
+Lookahead::Lookahead(const Instance& _formula, uint32_t _max_candidates) :
+    formula(_formula)
+,   max_candidates(_max_candidates)
+,   num_indexed(0)
+,   empty_clause(false)
+,   processed(0)
+{
+}
+
+// Indexes the clauses appended to the formula.
+void Lookahead::sync() {
+    uint64_t num_vars = formula.getNumVars();
+    if (values.size() < num_vars + 1) {
+        values.resize(num_vars + 1, 0);
+        occurs.resize(2 * num_vars + 2);
+    }
+    if (formula.getNumClauses() > UINT32_MAX)
+        throw std::runtime_error("too many clauses for the lookahead");
+    for (; num_indexed < formula.getNumClauses(); num_indexed++) {
+        const ClauseView c = formula[num_indexed];
+        uint32_t id = sizes.size();
+        sizes.push_back(c.size());
+        falses.push_back(0);
+        if (c.size() == 0) empty_clause = true;
+        if (c.size() == 1) units.push_back(c[0]);
+        for (int lit : c)
+            occurs[index(lit)].push_back(id);
+    }
+}
+
+// Assigns 'lit' and propagates it (returns false on a conflict).
+bool Lookahead::propagate(int lit) {
+    if (value(lit) != 0) return value(lit) > 0;
+    values[std::abs(lit)] = lit > 0 ? 1 : -1;
+    trail.push_back(lit);
+
+    bool ok = true;
+    while (ok && processed < trail.size()) {
+        int l = trail[processed++];
+        // the counters of all clauses of '-l' are updated even on a conflict to be restored by undo
+        for (uint32_t c : occurs[index(-l)]) {
+            uint32_t f = ++falses[c];
+            if (!ok || f + 1 < sizes[c]) continue;
+            if (f == sizes[c]) {
+                ok = false;
+                continue;
+            }
+            // the clause is satisfied or unit
+            int unassigned = 0;
+            bool satisfied = false;
+            for (int x : formula[c]) {
+                int v = value(x);
+                if (v > 0) { satisfied = true; break; }
+                if (v == 0) unassigned = x;
+            }
+            if (!satisfied && unassigned != 0) {
+                values[std::abs(unassigned)] = unassigned > 0 ? 1 : -1;
+                trail.push_back(unassigned);
+            }
+        }
+    }
+    return ok;
+}
+
+// Unassigns the literals from trail[size].
+void Lookahead::undo(size_t size) {
+    for (size_t i = trail.size(); i > size; i--) {
+        int l = trail[i - 1];
+        if (i <= processed)
+            for (uint32_t c : occurs[index(-l)])
+                falses[c]--;
+        values[std::abs(l)] = 0;
+    }
+    trail.resize(size);
+    processed = std::min(processed, size);
+}
+
+Lookahead::Outcome Lookahead::split(std::vector<int>& cube, int& var) {
+    sync();
+    if (empty_clause) return REFUTED;
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < units.size(); i++)
+        ok = propagate(units[i]);
+    for (size_t i = 0; ok && i < cube.size(); i++)
+        ok = propagate(cube[i]);
+    if (!ok) {
+        undo(0);
+        return REFUTED;
+    }
+
+    // candidates occurring most often in both polarities (in the order of indices on ties)
+    std::vector<std::pair<uint64_t, int>> candidates;
+    for (int v = 1; v < (int)values.size(); v++)
+        if (values[v] == 0 && occurs[index(v)].size() + occurs[index(-v)].size() > 0)
+            candidates.push_back(std::make_pair((uint64_t)(occurs[index(v)].size() + 1) * (occurs[index(-v)].size() + 1), v));
+    std::sort(candidates.begin(), candidates.end(),
+        [](const std::pair<uint64_t, int>& a, const std::pair<uint64_t, int>& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+
+    // the candidates after 'max_candidates' are probed only if all of them are implied
+    var = 0;
+    uint64_t best = 0;
+    uint32_t probed = 0;
+    for (size_t i = 0; i < candidates.size() && (probed < max_candidates || var == 0); i++) {
+        int v = candidates[i].second;
+        if (values[v] != 0) continue;   // implied by a failed literal
+        probed++;
+        size_t mark = trail.size();
+        bool     pos_ok = propagate(v);
+        uint64_t pos    = trail.size() - mark;
+        undo(mark);
+        bool     neg_ok = propagate(-v);
+        uint64_t neg    = trail.size() - mark;
+        undo(mark);
+
+        if (!pos_ok && !neg_ok) {
+            undo(0);
+            return REFUTED;
+        }
+        if (!pos_ok || !neg_ok) {
+            // the other literal is implied by the cube
+            int implied = pos_ok ? v : -v;
+            cube.push_back(implied);
+            if (!propagate(implied)) {
+                undo(0);
+                return REFUTED;
+            }
+            continue;
+        }
+        uint64_t score = pos * neg;
+        if (score > best) {
+            best = score;
+            var  = v;
+        }
+    }
+    undo(0);
+    return var == 0 ? NO_SPLIT : SPLIT;
+}
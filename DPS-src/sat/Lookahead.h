@@ -0,0 +1,49 @@
+#ifndef _DPS_LOOKAHEAD_H_
+#define _DPS_LOOKAHEAD_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "Instance.h"
+
+namespace DPS {
+
+// Lookahead on the clauses of an Instance to split cubes (conjunctions of literals) in the cube
+// mode. It is deterministic: the same clauses and cube give the same split. Clauses appended to
+// the Instance after the construction are indexed by the next call of split().
+class Lookahead {
+public:
+    enum Outcome { SPLIT, REFUTED, NO_SPLIT };
+
+    Lookahead(const Instance& formula, uint32_t max_candidates = 64);
+
+    // Propagates 'cube' and probes both literals of the 'max_candidates' unassigned variables
+    // occurring most often. The variable of which literals imply the most literals (the product
+    // of the two numbers, ties broken by the smaller index) is returned to 'var'. Failed literals
+    // found on the way are negated and appended to 'cube'. Returns REFUTED if the cube is falsified
+    // by propagation, and NO_SPLIT if no variable remains unassigned.
+    Outcome split(std::vector<int>& cube, int& var);
+
+private:
+    const Instance&                     formula;
+    uint32_t                            max_candidates;
+    uint64_t                            num_indexed;    // # of clauses of 'formula' indexed
+    bool                                empty_clause;
+    std::vector<int>                    units;          // unit clauses
+    std::vector<std::vector<uint32_t>>  occurs;         // clauses of each literal (see index)
+    std::vector<uint32_t>               sizes;          // size of each clause
+    std::vector<uint32_t>               falses;         // # of false literals of each clause
+    std::vector<int8_t>                 values;         // value of each variable (1, -1 or 0 if unassigned)
+    std::vector<int>                    trail;          // assigned literals
+    size_t                              processed;      // the counters of trail[0 ... processed-1] are updated
+
+    static size_t index(int lit) { return lit > 0 ? 2 * (size_t)lit : 2 * (size_t)-lit + 1; }
+    int    value(int lit) const  { int8_t v = values[lit > 0 ? lit : -lit]; return lit > 0 ? v : -v; }
+    void   sync();
+    bool   propagate(int lit);
+    void   undo(size_t size);
+};
+
+}
+
+#endif
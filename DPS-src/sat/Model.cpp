@@ -1,11 +1,19 @@
 #include <cassert>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
 #include "Model.h"
 
 namespace DPS {
 
 bool Model::satisfies(const Instance& instance) const {
-    for (const Clause& clause : instance)
-        if (!satisfies(clause))
+    return satisfies(instance, 0, instance.size());
+}
+
+bool Model::satisfies(const Instance& instance, size_t begin, size_t end) const {
+    for (size_t i = begin; i < end; i++)
+        if (!satisfies(instance[i]))
             return false;
     return true;
 }
@@ -17,40 +25,84 @@ bool Model::satisfies(const Clause& clause) const {
     return false;
 }
 
-bool Model::value(const int lit) const {
-    uint32_t var = std::abs(lit);    
-    assert(0 < var && var < size());
-    bool b = (*this)[var];
-    return lit > 0 ? b : !b;
+bool Model::satisfies(const ClauseView& clause) const {
+    for (const int lit : clause) 
+        if (value(lit))
+            return true;
+    return false;
 }
 
-template <class T> 
-static uint32_t numDigits(T number) {
-    int digits = (number < 0) ? 1 : 0;
-    while (number) {
-        number /= 10;
-        digits++;
+static const char digit_pairs[] =
+    "00010203040506070809" "10111213141516171819" "20212223242526272829" "30313233343536373839" "40414243444546474849"
+    "50515253545556575859" "60616263646566676869" "70717273747576777879" "80818283848586878889" "90919293949596979899";
+
+// writes the decimal digits of 'n' backward from 'end' and returns the first position
+static char* formatUnsigned(uint64_t n, char *end) {
+    while (n >= 100) {
+        end -= 2;
+        memcpy(end, digit_pairs + (n % 100) * 2, 2);
+        n /= 100;
+    }
+    if (n >= 10) {
+        end -= 2;
+        memcpy(end, digit_pairs + n * 2, 2);
     }
-    return digits;
+    else
+        *--end = '0' + n;
+    return end;
 }
 
-std::ostream & operator << (std::ostream& stream, const Model& model) {
-   uint32_t used_width = 0;
-   for (size_t var=1; var < model.size(); var++) {
-       int val = model[var] ? +var : -var;
-        uint32_t digits = numDigits(val);
-        if (used_width + 1 + digits >= 80) {
-            stream << std::endl;
+void Model::format(std::vector<char>& buf) const {
+    // each variable takes at most 22 chars (" -" + 20 digits) and each line at most 3 extra chars
+    buf.resize(num_vars * 25 + 8);
+    char *out = buf.data();
+    char tmp[24];
+    char *const tmp_end = tmp + sizeof(tmp);
+    uint32_t used_width = 0;
+    for (uint64_t var=1; var <= num_vars; var++) {
+        char *digits = formatUnsigned(var, tmp_end);
+        if (!(*this)[var]) *--digits = '-';
+        uint32_t len = tmp_end - digits;
+        if (used_width + 1 + len >= 80) {
+            *out++ = '\n';
             used_width = 0;
         }
         if (used_width == 0) {
-            stream << 'v';
+            *out++ = 'v';
             used_width++;
         }
-        stream << ' ' << val;
-        used_width += digits + 1;
+        *out++ = ' ';
+        memcpy(out, digits, len);
+        out += len;
+        used_width += len + 1;
+    }
+    if (used_width == 0)    // no variables
+        *out++ = 'v';
+    memcpy(out, " 0\n", 3);
+    out += 3;
+    buf.resize(out - buf.data());
+}
+
+void Model::write(int fd) const {
+    std::vector<char> buf;
+    format(buf);
+    const char *p = buf.data();
+    size_t rest = buf.size();
+    while (rest > 0) {
+        ssize_t n = ::write(fd, p, rest);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p    += n;
+        rest -= n;
     }
-    return stream << " 0" << std::endl;
+}
+
+std::ostream & operator << (std::ostream& stream, const Model& model) {
+    std::vector<char> buf;
+    model.format(buf);
+    return stream.write(buf.data(), buf.size());
 }
 
 }
\ No newline at end of file
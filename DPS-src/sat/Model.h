@@ -4,35 +4,81 @@
 #include <iostream>
 #include <vector>
 #include <cstdint>
+#include <cstdlib>
+#include <algorithm>
 
 #include "Clause.h"
 #include "Instance.h"
 
 namespace DPS {
 
-class Model : private std::vector<bool> {      // because STL classes have no virtual destructor
+// A (partial) assignment of variables 1 ... num_vars. The value of each variable is packed into
+// 2 bits (32 variables per word): bit 0 is set if the variable is true and bit 1 is set if it is
+// false, so a literal 'lit' is satisfied iff bit (lit < 0) of its variable is set. Unassigned
+// (don't-care) variables satisfy neither of their literals.
+class Model {
+public:
+    enum Value : uint8_t { UNDEF_VALUE = 0, TRUE_VALUE = 1, FALSE_VALUE = 2 };
+
 protected:
-    uint64_t num_vars;
+    uint64_t              num_vars;
+    std::vector<uint64_t> words;
+
+    static const uint32_t VARS_PER_WORD = 32;
+    uint64_t word(uint64_t var)  const { return words[var / VARS_PER_WORD]; }
+    static uint32_t shift(uint64_t var) { return (var % VARS_PER_WORD) * 2; }
+
 public:
-    Model(uint64_t vars) : num_vars(vars) { resize(vars + 1); }  // ignore index 0
+    Model(uint64_t vars) : num_vars(vars), words(vars / VARS_PER_WORD + 1, 0) {}  // all variables are unassigned
     Model(const Model&) = default;            // copy constructor
     Model& operator=(const Model&) = default; // copy assignment operator
     Model(Model&&) = default;                 // move constructor
     Model& operator=(Model&&) = default;      // move aissgnment operator
 
-    bool value(const int lit) const;
+    uint64_t getNumVars()                 const { return num_vars; }
+    Value    get(uint64_t var)            const { return (Value)((word(var) >> shift(var)) & 3); }
+    bool     isAssigned(uint64_t var)     const { return get(var) != UNDEF_VALUE; }
+    bool     operator[](uint64_t var)     const { return get(var) == TRUE_VALUE; }
+    void     set(uint64_t var, Value val) { 
+        uint64_t& w = words[var / VARS_PER_WORD];
+        w = (w & ~(3ULL << shift(var))) | ((uint64_t)val << shift(var));
+    }
+    void     set(uint64_t var, bool val)  { set(var, val ? TRUE_VALUE : FALSE_VALUE); }
+
+    // Bulk extraction from a value array of a base solver: the value of variable v is
+    // 'decode(values[v - 1])', which returns one of UNDEF_VALUE, TRUE_VALUE and FALSE_VALUE.
+    // Each word is assembled in a register and stored once.
+    template <class T, class Decode>
+    void load(const T *values, Decode decode) {
+        for (size_t i = 0; i < words.size(); i++) {
+            uint64_t first = i * VARS_PER_WORD;     // variable of the lowest bits
+            uint64_t last  = std::min<uint64_t>(first + VARS_PER_WORD - 1, num_vars);
+            uint64_t w = 0;
+            for (uint64_t var = std::max<uint64_t>(first, 1); var <= last; var++)
+                w |= (uint64_t)decode(values[var - 1]) << shift(var);
+            words[i] = w;
+        }
+    }
+
+    // returns true iff 'lit' is satisfied
+    bool value(const int lit) const {
+        uint64_t var = std::abs(lit);
+        return (word(var) >> (shift(var) + (lit < 0))) & 1;
+    }
     bool satisfies(const Instance& instance) const;
+    bool satisfies(const Instance& instance, size_t begin, size_t end) const;
     bool satisfies(const Clause& clause) const;
+    bool satisfies(const ClauseView& clause) const;
 
-    // provide some vector interfaces
-    using vector::size;
-    using vector::operator[];
-    using vector::begin;
-    using vector::end;
+    // formats the model in the DIMACS output format ('v' lines) into 'buf'
+    // (unassigned variables are printed as false)
+    void format(std::vector<char>& buf) const;
+    // writes the model to the file descriptor 'fd' with one write() call (unless it is interrupted)
+    void write(int fd) const;
 };
 
 std::ostream & operator << (std::ostream& stream, const Model& m);
 
 }
 
-#endif
\ No newline at end of file
+#endif
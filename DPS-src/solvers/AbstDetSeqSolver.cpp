@@ -1,6 +1,8 @@
 #define ABSTRACT_DET_SEQ_SOLVER_CPP
 
 #include <inttypes.h>
+#include <cstring>
+#include <algorithm>
 
 // Include files should be specified relatively to avoid confusion with same named files.
 #include "AbstDetSeqSolver.h"
@@ -18,8 +20,10 @@ AbstDetSeqSolver::AbstDetSeqSolver(int id, Sharer *_sharer, Options& _options
 ,   margin(options.getMargin())
 ,   periods(0)
 ,   mem_acc_lim(options.getMemAccLim())
-,   prd_clauses_queue(sharer->get(thn))
-,   fapp_clauses(options.getFAppClauses())
+,   acc_scale(options.getAccScale() > 0 ? options.getAccScale() : 1.0)
+,   scaled_acc_lim(mem_acc_lim * acc_scale)
+,   prd_clauses_queue(&sharer->get(thn))
+,   source_stats(sharer->num_threads, SourceStats{0, 0, 0, 0, 0, 0})
 ,   fapp_periods(options.getFAppPeriods())
 ,   last_fapp_period(0)
 ,   sum_mem_accs(0)
@@ -32,21 +36,120 @@ AbstDetSeqSolver::AbstDetSeqSolver(int id, Sharer *_sharer, Options& _options
 ,   prev_exp_confs(0)
 ,   start_real_time(realTime())
 ,   real_time_lim(options.getRealTimeLim())
-,   mem_use_lim(options.getMemUseLim())
+,   mem_use_lim(options.getMemLimPerJob() ? 0 : options.getMemUseLim())
+,   footprint_lim(0)
+,   footprint_exceeded(false)
 ,   num_imported_clauses(0)
 ,   num_exported_clauses(0)
 ,   num_forced_applications(0)
+,   launch_time(0)
+,   loading_time(0)
+,   first_conf_time(-1)
+,   conf_lim(0)
+,   incremental(false)
+,   stop_flag(nullptr)
+,   last_result(UNKNOWN)
 ,   input_formula(nullptr)
 ,   pmfinished(nullptr)
 ,   pcfinished(nullptr)
+,   live(nullptr)
+,   perf_prd_start()
+,   perf_prd()
+,   perf_total()
+,   perf_max_prd_cycles(0)
 {
     lbd_dist.add_equal_spacing(20); // 0%, 5%, 10%, ...
+    if (!options.getTraceFile().empty())
+        tracer.enable();
+}
+
+// Load the input formula given by 'setInputFormula' (called by the solver thread).
+void AbstDetSeqSolver::loadInputFormula() {
+    launch_time = realTime();
+    if (input_formula != nullptr) {
+        loadFormula(*input_formula);
+        input_formula = nullptr;
+    }
+    loading_time = realTime() - launch_time;
+    if (tracer.isEnabled()) {
+        trace_prd_start    = Tracer::now();
+        trace_prd_confs    = 0;
+        trace_prd_exported = 0;
+        trace_prd_imported = 0;
+    }
+    if (live)
+        publishLive(LIVE_RUNNING);
+}
+
+// Records the assumptions of which negations are in the final conflict 'core' of the base solver
+// (in the order of the assumptions).
+void AbstDetSeqSolver::setFailedAssumptions(std::vector<int>& core) {
+    std::sort(core.begin(), core.end());
+    failed_assumptions.clear();
+    for (int lit : assumptions)
+        if (std::binary_search(core.begin(), core.end(), -lit))
+            failed_assumptions.push_back(lit);
+}
+
+// Reports the result of this thread (called by the base solver at the end of solve()). A stop by
+// the conflict limit or the footprint limit occurs at a point that does not depend on the timing
+// of threads as well as a solution, so the sharer can choose the winner among them
+// deterministically. A thread stopped by the sharer has nothing to report. In the cube mode, a
+// thread that refutes its cube (the final conflict contains assumptions) or reaches one of those
+// limits retires at this point, which does not depend on the timing as well.
+void AbstDetSeqSolver::finish(SATResult result) {
+    bool exact = result != UNKNOWN || (conf_lim > 0 && getNumConflicts() >= conf_lim) || footprint_exceeded;
+    last_result = result;
+    if (sharer->isCubeMode() && exact && (result == UNKNOWN || (result == UNSAT && !failed_assumptions.empty()))) {
+        completeCurrPeriod();
+        prd_clauses_queue->retire();
+        pthread_cond_signal(pcfinished);
+        return;
+    }
+    if (exact || !sharer->shouldBeTerminated(periods))
+        sharer->IFinished(result, periods, thn, exact);
+    completeCurrPeriod();
+    pthread_cond_signal(pcfinished);
+}
+
+// The periods restart from 0 on the clause queues of a new sharer, while the base solver keeps its
+// clauses and the exchange state (pending clauses, period length, LBD distribution) is carried over.
+void AbstDetSeqSolver::restart(Sharer *_sharer) {
+    sharer            = _sharer;
+    prd_clauses_queue = &sharer->get(thn);
+    periods           = 0;
+    last_fapp_period  = 0;
+    start_real_time   = realTime();
+    real_time_lim     = options.getRealTimeLim();
+    conf_lim          = 0;
+    footprint_exceeded = false;
+    last_result       = UNKNOWN;
+    failed_assumptions.clear();
+}
+
+// Records the period that has just finished.
+void AbstDetSeqSolver::tracePeriod() {
+    uint64_t now   = Tracer::now();
+    uint64_t confs = getNumConflicts();
+    tracer.addPeriod(Tracer::PeriodRecord{ periods - 1, trace_prd_start, now, confs - trace_prd_confs,
+                                           num_exported_clauses - trace_prd_exported, trace_prd_imported,
+                                           perf_prd[PerfCounters::Cycles], perf_prd[PerfCounters::Instructions],
+                                           perf_prd[PerfCounters::LLCMisses], perf_prd[PerfCounters::BranchMisses] });
+    trace_prd_start    = now;
+    trace_prd_confs    = confs;
+    trace_prd_exported = num_exported_clauses;
+    trace_prd_imported = 0;
+}
+
+void AbstDetSeqSolver::recordFirstConflict() {
+    if (first_conf_time < 0)
+        first_conf_time = realTime() - launch_time;
 }
 
 bool AbstDetSeqSolver::checkPeriod(const char *msg) {
     if (canMoveToNextPeriod()) {
-        if (thn == 0 && options.verbose() > 2 &&  num_mem_accesses > mem_acc_lim * 1.1)
-            printf("c T%02d: EXCEED MEM ACC LIM %" PRIu64 "/%" PRIu64 " = %.1f (%s)\n", thn, num_mem_accesses, mem_acc_lim, (double)num_mem_accesses / mem_acc_lim,  msg ? msg : "");
+        if (thn == 0 && options.verbose() > 2 &&  num_mem_accesses > scaled_acc_lim * 1.1)
+            printf("c T%02d: EXCEED MEM ACC LIM %" PRIu64 "/%" PRIu64 " = %.1f (%s)\n", thn, num_mem_accesses, scaled_acc_lim, (double)num_mem_accesses / scaled_acc_lim,  msg ? msg : "");
 
         parchrono.start(ExchangingTime);
         exportSelectedClauses();
@@ -64,6 +167,13 @@ bool AbstDetSeqSolver::checkPeriod(const char *msg) {
         moveToNextPeriod();
 
         parchrono.stop(PeriodUpdateTime);
+        parchrono.closePeriod();
+        if (perf.isOpen())
+            samplePerfCounters();
+        if (tracer.isEnabled())
+            tracePeriod();
+        if (live)
+            publishLive(LIVE_RUNNING);
 
         if (shouldBeTerminated())
             return false;        
@@ -73,7 +183,7 @@ bool AbstDetSeqSolver::checkPeriod(const char *msg) {
 
 void AbstDetSeqSolver::exportSelectedClauses() {
     uint32_t before_lits = exp_clauses_buf.getNumLiterals();  // DEBUG
-    uint32_t exp_clauses = exp_clauses_buf.exportTo(prd_clauses_queue.last(), exp_lits_lim);    
+    uint32_t exp_clauses = exp_clauses_buf.exportTo(prd_clauses_queue->last(), exp_lits_lim);    
     uint32_t after_lits = exp_clauses_buf.getNumLiterals();   // DEBUG    
     num_exported_clauses += exp_clauses;
 
@@ -121,10 +231,11 @@ uint64_t AbstDetSeqSolver::getNewPeriodLength() {
 }
 
 void AbstDetSeqSolver::moveToNextPeriod() {
-    assert(num_mem_accesses >= mem_acc_lim);
-    num_mem_accesses -= mem_acc_lim;
+    assert(num_mem_accesses >= scaled_acc_lim);
+    num_mem_accesses -= scaled_acc_lim;
     periods++;
     mem_acc_lim = next_mem_acc_lim;
+    scaled_acc_lim = mem_acc_lim * acc_scale;
 }
 
 bool AbstDetSeqSolver::importClauses() {
@@ -143,18 +254,32 @@ bool AbstDetSeqSolver::importClauses() {
                     break;
             }
             else {
+                // only actual waits are recorded by the tracer
+                bool     traced = tracer.isEnabled() && !prdClauses.isAdditionCompleted();
+                uint64_t start  = traced ? Tracer::now() : 0;
+                if (live) live->state.store(LIVE_WAITING, std::memory_order_relaxed);
                 parchrono.start(WaitingTime);
                 prdClauses.waitAdditionCompleted();
                 parchrono.stop(WaitingTime);
+                if (live) live->state.store(LIVE_RUNNING, std::memory_order_relaxed);
+                if (traced)
+                    tracer.addWait(Tracer::WaitRecord{ periods, start, Tracer::now(), target, prdClauses.period() });
             }
+            // the thread has retired before this period (nothing is imported from it hereafter)
+            if (queue.isRetired(prdClauses.period()))
+                break;
 
             for (int j=0; j < prdClauses.size(); j++) {
-                const Clause& c = prdClauses[j];
-                if (c.size() > 1)
-                    imported_clauses.push_back(c);
+                const ClauseView c = prdClauses[j];
+                if (c.size() > 1) {
+                    imported_clauses.emplace_back(c.begin(), c.end());
+                    imported_sources.push_back(target);
+                }
                 else
-                    imported_unit_clauses.push_back(c);
+                    imported_unit_clauses.emplace_back(c.begin(), c.end());
             }
+            source_stats[target].received += prdClauses.size();
+            trace_prd_imported += prdClauses.size();
             sum_prd_len_cand += prdClauses.getPrdLenCand();
             queue.completeExportation(thn, prdClauses);
         }
@@ -180,25 +305,133 @@ bool AbstDetSeqSolver::importClauses() {
     return true;
 }
 
+// Erases the first 'n' imported clauses that have been applied by the base solver.
+void AbstDetSeqSolver::eraseImportedClauses(size_t n) {
+    imported_clauses.erase(imported_clauses.begin(), imported_clauses.begin() + n);
+    imported_sources.erase(imported_sources.begin(), imported_sources.begin() + n);
+}
+
+uint64_t AbstDetSeqSolver::getNumPromotedClauses() const {
+    uint64_t n = 0;
+    for (const SourceStats& s : source_stats) n += s.promoted;
+    return n;
+}
+
+uint64_t AbstDetSeqSolver::getNumEvictedClauses() const {
+    uint64_t n = 0;
+    for (const SourceStats& s : source_stats) n += s.evicted;
+    return n;
+}
+
+// Imported non-unit clauses are attached at the current decision level, so they are applied 
+// as soon as they are imported.
 bool AbstDetSeqSolver::shouldApplyImportedClauses() {
-    // If unit clauses exist, then it should be applied immediately
-    if (imported_unit_clauses.size() > 0
-        && periods >= last_fapp_period + fapp_periods) {
-        last_fapp_period = periods;
-        return true;
-    }
-    // If there are many imported clauses, then it should be applied
-    if (fapp_clauses > 0 
-        && imported_clauses.size() / sharer->getNumThreads() >= fapp_clauses 
-        && periods >= last_fapp_period + fapp_periods) {
-        last_fapp_period = periods;
-        return true;
-    }
-    return false;
+    return imported_clauses.size() > 0 || shouldApplyImportedUnitClauses();
 }
 
+// Imported unit clauses may require backtracking to the root level, so they are applied at 
+// most once every 'fapp-periods' periods (see incNumForcedApplications).
+bool AbstDetSeqSolver::shouldApplyImportedUnitClauses() const {
+    return imported_unit_clauses.size() > 0 && periods >= last_fapp_period + fapp_periods;
+}
+
+// The estimated bytes of the base solver depend only on its own search (unlike the RSS of the
+// process), so a stop by 'footprint_lim' is as deterministic as a stop by the conflict limit.
 bool AbstDetSeqSolver::shouldBeTerminated() {
+    if (footprint_lim > 0 && !footprint_exceeded && getMemoryFootprint() > footprint_lim)
+        footprint_exceeded = true;
     return sharer->shouldBeTerminated(periods) 
+        || footprint_exceeded
         || (mem_use_lim > 0 && usedMemory() > mem_use_lim)
-        || (real_time_lim > 0 && realTime() > start_real_time + real_time_lim);    
+        || (real_time_lim > 0 && realTime() > start_real_time + real_time_lim)
+        || (conf_lim > 0 && getNumConflicts() >= conf_lim)
+        || (stop_flag != nullptr && *stop_flag);
+}
+
+bool AbstDetSeqSolver::openPerfCounters(std::string& error) {
+    if (!perf.open(error)) return false;
+    perf.read(perf_prd_start);
+    return true;
+}
+
+void AbstDetSeqSolver::closePerfCounters() {
+    if (!perf.isOpen()) return;
+    perf.read(perf_total);
+    perf.close();
+}
+
+// Records the hardware counters spent in the period that has just finished.
+void AbstDetSeqSolver::samplePerfCounters() {
+    PerfCounters::Sample now;
+    if (!perf.read(now)) return;
+    for (int e = 0; e < PerfCounters::NumEvents; e++)
+        perf_prd.values[e] = now.values[e] - perf_prd_start.values[e];
+    perf_prd_start = now;
+    perf_max_prd_cycles = std::max(perf_max_prd_cycles, perf_prd[PerfCounters::Cycles]);
+}
+
+void AbstDetSeqSolver::publishLive(LiveState state) {
+    if (live == nullptr) return;
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    live->period.store(periods, relaxed);
+    live->conflicts.store(getNumConflicts(), relaxed);
+    live->propagations.store(getNumPropagations(), relaxed);
+    live->imported.store(num_imported_clauses, relaxed);
+    live->exported.store(num_exported_clauses, relaxed);
+    if (periods % LIVE_LBD_INTERVAL == 0 || state == LIVE_FINISHED)
+        for (uint32_t q = 0; q < LIVE_QUANTILES; q++) {
+            double   d = getLBDQuantile((q + 1) * 0.05);
+            uint64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            live->lbd_quantiles[q].store(bits, relaxed);
+        }
+    live->update_time.store(Tracer::now(), relaxed);
+    live->state.store(state, relaxed);
+}
+
+void AbstDetSeqSolver::reportStats(StatsRecord& stats) {
+    stats.section("Basic stats", 2);
+    stats.set(thn, "Conflicts",         getNumConflicts());
+    stats.set(thn, "Decisions",         getNumDecisions());
+    stats.set(thn, "Propagations",      getNumPropagations());
+    stats.set(thn, "Restarts",          getNumRestarts());
+    stats.set(thn, "Periods",           periods);
+    stats.set(thn, "PeriodLength",      mem_acc_lim);
+    stats.set(thn, "Exported",          num_exported_clauses);
+    stats.set(thn, "Imported",          num_imported_clauses);
+    stats.set(thn, "Promoted",          getNumPromotedClauses());
+    stats.set(thn, "Evicted",           getNumEvictedClauses());
+    stats.set(thn, "ForcedApplication", num_forced_applications);
+    stats.set(thn, "ExpLBDThreshold",   getExpLBDthreshold());
+    for (int q = 5; q <= 30; q += 5) {
+        char key[32];
+        snprintf(key, sizeof(key), "LBD%02dQuantile", q);
+        stats.set(thn, key, StatsRecord::Value(getLBDQuantile((double)q / 100.0), 1));
+    }
+
+    stats.section("Time stats for parallel proccessing", 2);
+    double running    = parchrono.getTime(RunningTime);
+    double waiting    = parchrono.getTime(WaitingTime);
+    double exchanging = parchrono.getTime(ExchangingTime);
+    double prd_proc   = parchrono.getTime(PeriodUpdateTime);
+    stats.set(thn, "RunningTime",       running);
+    stats.set(thn, "WaitingTime",       waiting);
+    stats.set(thn, "ExchangingTime",    exchanging);
+    stats.set(thn, "PeriodProcTime",    prd_proc);
+    // distributions of the time spent in each period (# of periods per log-scale time range)
+    static const char* hist_names[ProcTypes] = { "RunningTimeHist", "WaitingTimeHist", "ExchangingTimeHist", "PeriodProcTimeHist" };
+    for (int type = 0; type < ProcTypes; type++)
+        stats.set(thn, hist_names[type], parchrono.getHistogram((ProcName)type).toString(), false);
+    stats.set(thn, "LoadingTime",       loading_time, false);
+    stats.set(thn, "FirstConflictTime", first_conf_time, false);
+    stats.set(thn, "NonWaitingTime",    running + exchanging + prd_proc);
+    stats.set(thn, "SolvingTime",       running + exchanging + prd_proc + waiting);
+
+    if (perf_total[PerfCounters::Cycles] > 0) {
+        stats.section("Hardware counters", 2);
+        for (int e = 0; e < PerfCounters::NumEvents; e++)
+            stats.set(thn, PerfCounters::getName(e), perf_total[e]);
+        stats.set(thn, "IPC", StatsRecord::Value((double)perf_total[PerfCounters::Instructions] / perf_total[PerfCounters::Cycles], 2), false);
+        stats.set(thn, "MaxPeriodCycles", perf_max_prd_cycles, false);
+    }
 }
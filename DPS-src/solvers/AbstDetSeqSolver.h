@@ -8,17 +8,32 @@
 #include "ThreadLocalVars.h"
 #include "../parallel/Sharer.h"
 #include "../parallel/Options.h"
+#include "../parallel/LiveStats.h"
 #include "../period/ClauseBuffer.h"
 #include "../sat/Instance.h"
 #include "../sat/Model.h"
 #include "../utils/p2.h"
 #include "../utils/Chronometer.h"
+#include "../utils/Tracer.h"
+#include "../utils/Stats.h"
+#include "../utils/PerfCounters.h"
 
 namespace DPS {
 
 class AbstDetSeqSolver {
     friend class DetParallelSolver;
 
+public:
+    // statistics of clauses imported from a source thread
+    struct SourceStats {
+        uint64_t received;      // # of received clauses
+        uint64_t promoted;      // # of clauses promoted from the probationary tier
+        uint64_t evicted;       // # of clauses evicted from the probationary tier
+        uint64_t reasons;       // # of times a clause was resolved as a reason in conflict analysis
+        uint64_t conflicts;     // # of times a clause was falsified as a conflict
+        uint64_t retained;      // # of times a clause survived a reduction of learnt clauses
+    };
+
 protected:
     uint32_t            thn;
     Sharer*             sharer;    
@@ -26,11 +41,14 @@ protected:
     uint32_t            margin;
     uint64_t            periods;
     uint64_t            mem_acc_lim;
-    PrdClausesQueue&    prd_clauses_queue;
+    double              acc_scale;          // # of memory accesses of the base solver per memory access of a period
+    uint64_t            scaled_acc_lim;     // 'mem_acc_lim' in memory accesses of the base solver
+    PrdClausesQueue*    prd_clauses_queue;
     ClauseBuffer        exp_clauses_buf;
     std::vector<Clause> imported_clauses;
+    std::vector<uint32_t> imported_sources;   // source thread of each clause in 'imported_clauses'
     std::vector<Clause> imported_unit_clauses;
-    uint32_t            fapp_clauses;
+    std::vector<SourceStats> source_stats;
     uint32_t            fapp_periods;    
     uint64_t            last_fapp_period;
     uint64_t            sum_mem_accs;
@@ -44,10 +62,21 @@ protected:
     p2_t                lbd_dist;
     double              start_real_time;
     double              real_time_lim;
-    double              mem_use_lim;
+    double              mem_use_lim;        // limit on the RSS of the process [MB] (0 for unlimited)
+    uint64_t            footprint_lim;      // limit on the estimated bytes of the base solver (0 for unlimited, the share of a job)
+    bool                footprint_exceeded; // the estimated bytes of the base solver have exceeded 'footprint_lim'
     uint64_t            num_imported_clauses;
     uint64_t            num_exported_clauses;
     uint64_t            num_forced_applications;
+    double              launch_time;        // real time when the solver thread is launched
+    double              loading_time;       // time to load the input formula
+    double              first_conf_time;    // time from the launch to the first conflict (< 0 if none)
+    uint64_t            conf_lim;           // conflict limit (0 for unlimited, used by the warm-up run of the memory planner)
+    bool                incremental;        // the base solver is kept for the next call of solve() (no variable elimination)
+    std::vector<int>    assumptions;        // assumptions of the current call of solve()
+    std::vector<int>    failed_assumptions; // assumptions in the final conflict of the last call
+    const std::atomic<bool>* stop_flag;     // set by DetParallelSolver::interrupt() (nullptr if none)
+    SATResult           last_result;        // result of this thread in the last call
     
     // input formula that is shared with each solver    
     Instance const *input_formula;
@@ -56,14 +85,30 @@ protected:
     // condition variable that says that a thread as finished
     pthread_cond_t *pcfinished; 
 
-    bool     canMoveToNextPeriod() const { return num_mem_accesses >= mem_acc_lim; };
+    bool     canMoveToNextPeriod() const { return num_mem_accesses >= scaled_acc_lim; };
     void     exportSelectedClauses();
     uint64_t getNewPeriodLength(); 
     void     moveToNextPeriod();
     bool     importClauses();
     void     completeCurrPeriod() { return sharer->completeCurrPeriod(thn, getNewPeriodLength()); };
+    void     loadInputFormula();
+    void     setFailedAssumptions(std::vector<int>& core);
+    void     finish(SATResult result);
 
     Chronometer parchrono;    // chronometer for parallel proccessing
+    Tracer      tracer;       // timeline of periods (enabled by the 'trace' option)
+    uint64_t    trace_prd_start;        // start time of the current period
+    uint64_t    trace_prd_confs;        // # of conflicts at the start of the current period
+    uint64_t    trace_prd_exported;     // # of exported clauses at the start of the current period
+    uint64_t    trace_prd_imported;     // # of clauses received at the end of the current period
+    void        tracePeriod();
+    LiveSlot*   live;         // live counters in shared memory (nullptr unless the 'live-shm' option is given)
+    PerfCounters          perf;             // hardware counters of this thread (the 'perf' option)
+    PerfCounters::Sample  perf_prd_start;   // counters at the start of the current period
+    PerfCounters::Sample  perf_prd;         // counters spent in the last period
+    PerfCounters::Sample  perf_total;       // counters at the end of the thread
+    uint64_t              perf_max_prd_cycles;
+    void        samplePerfCounters();
 
 public:
     AbstDetSeqSolver(int id, Sharer *_sharer, Options& options);
@@ -72,26 +117,51 @@ public:
     
     bool     checkPeriod(const char *msg = nullptr);
     bool     shouldApplyImportedClauses();
+    bool     shouldApplyImportedUnitClauses() const;
     bool     shouldBeTerminated();
+    // prepares the next call of solve() (see DetParallelSolver::setIncremental)
+    void     restart(Sharer *_sharer);
       
     // Main methods
     virtual SATResult solve() = 0;
     virtual bool loadFormula(const Instance& clauses) = 0;
+    // whether the base solver accepts clauses and assumptions after solving
+    virtual bool supportsIncremental() const { return false; }
     // Sharing strategy
     virtual void incExpClauseGen() {}
     virtual void decExpClauseGen() {}
 
     void setRealTimeLim(double time)             { real_time_lim = time; }
     void setMemUseLim(double mem)                { mem_use_lim = mem; }
+    void setFootprintLim(uint64_t bytes)         { footprint_lim = bytes; }
     void setInputFormula(Instance const *p)      { input_formula = p; }
+    void setConflictLim(uint64_t n)              { conf_lim = n; }
+    void setIncremental(bool b)                  { incremental = b; }
+    void setAssumptions(const std::vector<int>& a) { assumptions = a; }
+    void setLiveSlot(LiveSlot *slot)             { live = slot; }
+    void setStopFlag(const std::atomic<bool> *f) { stop_flag = f; }
+    // publishes the counters of this thread to the live slot
+    void publishLive(LiveState state);
+    // hardware counters are opened and closed by the solver thread itself
+    bool openPerfCounters(std::string& error);
+    void closePerfCounters();
+    void setFinishedSignal(pthread_mutex_t *m, pthread_cond_t *c) { pmfinished = m; pcfinished = c; }
 
     int                     getThreadID()   const    { return thn; }
     Sharer*                 getSharer()     const    { return sharer; }
+    const Options&          getOptions()    const    { return options; }
     uint64_t                getCurrPeriod() const    { return periods; }
     uint64_t                getMemAccLim()  const    { return mem_acc_lim; }
+    double                  getAccScale()   const    { return acc_scale; }
     std::vector<Clause>&    getImportedClauses()     { return imported_clauses; }
+    std::vector<uint32_t>&  getImportedSources()     { return imported_sources; }
     std::vector<Clause>&    getImportedUnitClauses() { return imported_unit_clauses; }
+    // an imported clause shrunk to the unit 'lit' is applied together with imported unit clauses
+    void                    deferImportedUnit(int lit) { imported_unit_clauses.push_back(Clause(1, lit)); }
     Chronometer&            getChronometer()         { return parchrono; }
+    const Tracer&           getTracer()     const    { return tracer; }
+    const std::vector<int>& getFailedAssumptions() const { return failed_assumptions; }
+    SATResult getLastResult() const { return last_result; }
     
     // statistics of base solver
     virtual uint64_t        getNumConflicts() = 0;
@@ -102,12 +172,30 @@ public:
     virtual Model           getModel() = 0;
     virtual uint32_t        getExpLBDthreshold() { return 0; }
     virtual char            getSolverState() { return ' '; }
+    // reports the statistics of this thread (base solvers may add their own counters)
+    virtual void            reportStats(StatsRecord& stats);
+
+    // memory estimators of base solver (used by the memory planner)
+    virtual uint64_t        getMemoryFootprint() = 0;               // estimated bytes used by the base solver
+    virtual uint64_t        getRedundantClauseBytes() = 0;          // estimated bytes used by redundant clauses
+    virtual void            setRedundantClauseLimit(uint64_t n) = 0;  // soft limit on # of redundant clauses (0 for unlimited)
 
     uint64_t getNumImportedClauses()    const    { return num_imported_clauses; }
-    void     incNumImportedClauses()             { num_imported_clauses++;      }
+    void     incNumImportedClauses(uint64_t n = 1) { num_imported_clauses += n;   }
     uint64_t getNumExportedClauses()    const    { return num_exported_clauses; }
     uint64_t getNumForcedApplications() const    { return num_forced_applications; }
-    void     incNumForcedApplications()          { num_forced_applications++; }
+    void     incNumForcedApplications()          { num_forced_applications++; last_fapp_period = periods; }
+    void     eraseImportedClauses(size_t n);
+    void     promoteImportedClause(uint32_t src)      { source_stats[src].promoted++; }
+    void     evictImportedClause(uint32_t src)        { source_stats[src].evicted++; }
+    void     useImportedClause(uint32_t src, bool conflict) { if (conflict) source_stats[src].conflicts++; else source_stats[src].reasons++; }
+    void     retainImportedClause(uint32_t src)       { source_stats[src].retained++; }
+    const SourceStats& getSourceStats(uint32_t src) const { return source_stats[src]; }
+    uint64_t getNumPromotedClauses()    const;
+    uint64_t getNumEvictedClauses()     const;
+    void     recordFirstConflict();
+    double   getLoadingTime()           const    { return loading_time; }
+    double   getFirstConflictTime()     const    { return first_conf_time; }
 
     double   getLBDQuantile(double q)            { return lbd_dist.result(q); }
     double   getLBDUpperbound()                  { return getNumConflicts() < 1000 || options.getExpLBDQLim() == 1.0 ? UINT32_MAX : getLBDQuantile(options.getExpLBDQLim()); }
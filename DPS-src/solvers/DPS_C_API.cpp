@@ -19,6 +19,36 @@ int DPS_shouldApplyImportedClauses(void *wrapper) {
     return solver->shouldApplyImportedClauses();
 }
 
+void DPS_recordFirstConflict(void *wrapper) {
+    AbstDetSeqSolver *solver = reinterpret_cast<AbstDetSeqSolver *>(wrapper);
+    solver->recordFirstConflict();
+}
+
+void DPS_promoteImportedClause(void *wrapper, unsigned int source) {
+    AbstDetSeqSolver *solver = reinterpret_cast<AbstDetSeqSolver *>(wrapper);
+    solver->promoteImportedClause(source);
+}
+
+void DPS_evictImportedClause(void *wrapper, unsigned int source) {
+    AbstDetSeqSolver *solver = reinterpret_cast<AbstDetSeqSolver *>(wrapper);
+    solver->evictImportedClause(source);
+}
+
+void DPS_useImportedClause(void *wrapper, unsigned int source, int conflict) {
+    AbstDetSeqSolver *solver = reinterpret_cast<AbstDetSeqSolver *>(wrapper);
+    solver->useImportedClause(source, conflict != 0);
+}
+
+void DPS_retainImportedClause(void *wrapper, unsigned int source) {
+    AbstDetSeqSolver *solver = reinterpret_cast<AbstDetSeqSolver *>(wrapper);
+    solver->retainImportedClause(source);
+}
+
+void DPS_deferImportedUnit(void *wrapper, int lit) {
+    AbstDetSeqSolver *solver = reinterpret_cast<AbstDetSeqSolver *>(wrapper);
+    solver->deferImportedUnit(lit);
+}
+
 // Kissat interfaces
 
 bool DPS_kissat_shouldBeExported(void *wrapper, unsigned int lbd) {
@@ -26,52 +56,19 @@ bool DPS_kissat_shouldBeExported(void *wrapper, unsigned int lbd) {
     return solver->shouldBeExported(lbd);
 }
 
-void DPS_kissat_uncheckedExportClause(void *wrapper, const int* clause, unsigned int size, unsigned int lbd) {
+int* DPS_kissat_reserveExport(void *wrapper, unsigned int size) {
     KissatWrapper *solver = reinterpret_cast<KissatWrapper *>(wrapper);
-    solver->uncheckedExportClause(clause, size, lbd);
+    return solver->reserveExport(size);
 }
 
-int DPS_kissat_applyImportedClauses(void *wp) {
-    KissatWrapper *wrapper = reinterpret_cast<KissatWrapper *>(wp);
-    kissat *solver = wrapper->getKissatSolver();
-    if (kissat_get_decision_level(solver) > 0) { 
-        wrapper->incNumForcedApplications();
-        kissat_forced_restart(solver);
-    }
-    
-    wrapper->getChronometer().start(DPS::ExchangingTime);
-
-    // Applying imported clauses involves propagations that may cause new importation.
-    // These clauses should be separated from new importation.
-    std::vector<DPS::Clause> importedUnitClauses = std::move(wrapper->getImportedUnitClauses());
-    std::vector<DPS::Clause> importedClauses = std::move(wrapper->getImportedClauses());
-
-    bool ret = true;
-    // First, applies unit clauses
-    for (DPS::Clause& clause : importedUnitClauses) {
-        int res = kissat_add_imported_unit_clause(solver, clause[0]);
-        if (res == 1) continue;     // already satisfied
-        wrapper->incNumImportedClauses();
-        if (res == -1) {
-            ret = false;
-            break;
-        }
-    }
-    importedUnitClauses.clear();
-    // Then, applies non-unit clauses
-    for (DPS::Clause& clause : importedClauses) {
-        int res = kissat_add_imported_clause(solver, clause.data(), clause.size());
-        if (res == 1) continue;     // already satisfied
-        wrapper->incNumImportedClauses();
-        if (res == -1) {
-            ret = false;
-            break;
-        }
-    }
-    importedClauses.clear();
-    wrapper->getChronometer().stop(DPS::ExchangingTime);
-
-    return ret;
+void DPS_kissat_commitExport(void *wrapper) {
+    KissatWrapper *solver = reinterpret_cast<KissatWrapper *>(wrapper);
+    solver->commitExport();
+}
+
+int DPS_kissat_applyImportedClauses(void *wrapper) {
+    KissatWrapper *solver = reinterpret_cast<KissatWrapper *>(wrapper);
+    return solver->applyImportedClauses();
 }
 
 }
\ No newline at end of file
@@ -9,9 +9,16 @@ namespace DPS {
 int DPS_checkPeriod(void *wrapper, const char *msg);
 int DPS_shouldBeTerminated(void *wrapper);
 int DPS_shouldApplyImportedClauses(void *wrapper);
+void DPS_recordFirstConflict(void *wrapper);
+void DPS_promoteImportedClause(void *wrapper, unsigned int source);
+void DPS_evictImportedClause(void *wrapper, unsigned int source);
+void DPS_useImportedClause(void *wrapper, unsigned int source, int conflict);
+void DPS_retainImportedClause(void *wrapper, unsigned int source);
+void DPS_deferImportedUnit(void *wrapper, int lit);
 
 bool DPS_kissat_shouldBeExported(void *wrapper, unsigned int lbd);
-void DPS_kissat_uncheckedExportClause(void *wrapper, const int* clause, unsigned int size, unsigned int lbd);
+int* DPS_kissat_reserveExport(void *wrapper, unsigned int size);
+void DPS_kissat_commitExport(void *wrapper);
 int DPS_kissat_applyImportedClauses(void *wrapper);
 
 #ifdef __cplusplus
@@ -3,42 +3,6 @@
 
 using namespace DPS;
 
-struct PaKisParam {
-    uint32_t tier1;
-    uint32_t chrono;
-    uint32_t stable;
-    uint32_t walkinitially;
-    uint32_t target;
-    uint32_t phase;
-};
-
-static PaKisParam pakisParams[] = {
-    { 2, 1, 1, 0, 1, 1 }, 
-    { 2, 1, 1, 0, 2, 1 },
-    { 2, 1, 0, 0, 1, 1 },
-    { 2, 0, 1, 0, 1, 1 },
-    { 2, 0, 1, 0, 1, 0 },
-    { 2, 1, 1, 0, 1, 0 },
-    { 2, 0, 2, 0, 1, 1 },
-    { 2, 1, 1, 0, 0, 1 },
-    { 2, 0, 1, 0, 0, 0 },
-    { 2, 1, 1, 0, 0, 0 },
-    { 2, 1, 1, 1, 1, 1 },
-    { 2, 0, 1, 0, 2, 1 },
-    { 2, 0, 1, 0, 2, 0 },
-    { 3, 0, 1, 0, 2, 0 },
-    { 3, 0, 1, 0, 2, 1 },
-    { 2, 1, 1, 0, 2, 0 },
-    { 2, 0, 2, 0, 2, 1 },
-    { 2, 1, 1, 0, 0, 1 },
-    { 2, 0, 1, 0, 0, 0 },
-    { 2, 1, 1, 0, 0, 0 },
-    { 3, 1, 1, 0, 0, 1 },
-    { 3, 1, 1, 0, 2, 1 },
-    { 2, 1, 1, 1, 2, 1 },
-    { 2, 0, 0, 0, 1, 1 },
-};
-
 static int gcd(int a, int b) {
     if (a % b == 0)
         return b;
@@ -54,6 +18,7 @@ KissatWrapper::KissatWrapper(int id, Sharer *sharer, Options& options) :
     if (!solver) throw std::runtime_error("could not allocate memory for KissatWrapper::kissat");
     kissat_set_wrapper(solver, this, id);
     kissat_set_option(solver, "quiet", 1);
+    kissat_set_probation(solver, options.getProbConfs() > 0);
 
     // diversification strategy
     if (id) {
@@ -75,45 +40,80 @@ KissatWrapper::KissatWrapper(int id, Sharer *sharer, Options& options) :
         int elim = id % dem < num ? 1 : 0;
         kissat_set_option(solver, "eliminate", elim);
     }
-    // pakis
-    if (options.getKSPaKis()) {
-        int i = id % (sizeof(pakisParams) / sizeof(PaKisParam));
-        kissat_set_option(solver, "tier1",         pakisParams[i].tier1);
-        kissat_set_option(solver, "chrono",        pakisParams[i].chrono);
-        kissat_set_option(solver, "stable",        pakisParams[i].stable);
-        kissat_set_option(solver, "walkinitially", pakisParams[i].walkinitially);
-        kissat_set_option(solver, "target",        pakisParams[i].target);
-        kissat_set_option(solver, "phase",         pakisParams[i].phase);
-    }
+    // diversification profile (e.g., 'pakis' with search parameters of PaKis)
+    for (const auto& p : options.getProfile().getParams("kissat", id))
+        setParam(solver, p.first, p.second);
 }
 
 KissatWrapper::~KissatWrapper() {
     kissat_release(solver);
 }
 
+// Any option of kissat can be set by diversification profiles
+bool KissatWrapper::setParam(kissat *solver, const std::string& name, double value) {
+    if (value != (int)value || !kissat_is_valid_option(name.c_str(), (int)value))
+        return false;
+    if (solver) kissat_set_option(solver, name.c_str(), (int)value);
+    return true;
+}
+
 bool KissatWrapper::shouldBeExported(uint32_t lbd) {
     lbd_dist.add(lbd);
     uint32_t threshold = getExpLBDthreshold();    
     return 0 < threshold && lbd <= threshold;
 }
 
-void KissatWrapper::uncheckedExportClause(const int *clause, uint32_t len, uint32_t lbd) {
+int* KissatWrapper::reserveExport(uint32_t size) {
     parchrono.start(ExchangingTime);
-    exp_tmp.clear();
-    const int *end = clause + len;
-    for (const int *p = clause; p != end; p++)
-        exp_tmp.push_back(*p);
-    // export clause
-    exp_clauses_buf.addClause(exp_tmp, exp_tmp.size());
+    return exp_clauses_buf.reserve(size, size);
+}
+
+void KissatWrapper::commitExport() {
+    exp_clauses_buf.commit();
     parchrono.stop(ExchangingTime);
 }
 
-SATResult KissatWrapper::solve() {
-    if (input_formula != nullptr) {
-        loadFormula(*input_formula);
-        input_formula = nullptr;
+// Passes all imported clauses to kissat in one call. Unit clauses are applied first (which
+// may backtrack to their level), then non-unit clauses are attached at the current decision
+// level. If one of them is falsified, the rest is applied after the conflict is analyzed.
+// Imported literals are propagated together by the search loop of kissat.
+bool KissatWrapper::applyImportedClauses() {
+    parchrono.start(ExchangingTime);
+
+    imp_units.clear();
+    if (imported_unit_clauses.size() > 0 && (kissat_get_decision_level(solver) == 0 || shouldApplyImportedUnitClauses())) {
+        for (const Clause& clause : imported_unit_clauses)
+            imp_units.push_back(clause[0]);
+        imported_unit_clauses.clear();
+    }
+    imp_clauses.clear();
+    imp_sizes.clear();
+    for (const Clause& clause : imported_clauses) {
+        imp_clauses.push_back(clause.data());
+        imp_sizes.push_back(clause.size());
     }
 
+    dps_import_batch batch;
+    batch.units       = imp_units.data();
+    batch.num_units   = imp_units.size();
+    batch.clauses     = imp_clauses.data();
+    batch.sizes       = imp_sizes.data();
+    batch.sources     = imported_sources.data();
+    batch.num_clauses = imp_clauses.size();
+    int res = kissat_import_clauses(solver, &batch);
+
+    incNumImportedClauses(batch.imported);
+    if (batch.backtracked)
+        incNumForcedApplications();
+    eraseImportedClauses(batch.applied);
+    parchrono.stop(ExchangingTime);
+
+    return res != -1;
+}
+
+SATResult KissatWrapper::solve() {
+    loadInputFormula();
+
     parchrono.start(RunningTime);
     int res = kissat_solve(solver);
     parchrono.stop(RunningTime);
@@ -122,21 +122,14 @@ SATResult KissatWrapper::solve() {
         result = SAT;
     else if (res == 20)
         result = UNSAT;
-    sharer->IFinished(result, periods, thn);
-    completeCurrPeriod();
-    pthread_cond_signal(pcfinished);
+    finish(result);
     return result;
 }
 
 bool KissatWrapper::loadFormula(const Instance& clauses) {
     num_vars = clauses.getNumVars();
     kissat_reserve (solver, num_vars);
-    for (auto clause : clauses) {
-        for (auto n : clause) 
-            kissat_add(solver, n);
-        kissat_add(solver, 0);            
-    }
-    return true;
+    return kissat_add_clauses(solver, clauses.getLiterals(), clauses.getOffsets(), clauses.getNumClauses()) == 0;
 }
 
 uint64_t KissatWrapper::getNumConflicts()        { return kissat_get_num_conflicts(solver); } 
@@ -146,14 +139,18 @@ uint64_t KissatWrapper::getNumRestarts()         { return kissat_get_num_restart
 uint64_t KissatWrapper::getNumRedundantClauses() { return kissat_get_num_redudants(solver); }
 char     KissatWrapper::getSolverState()         { return kissat_get_solver_state(solver); }
 
+uint64_t KissatWrapper::getMemoryFootprint()      { return kissat_get_memory_usage(solver); }
+uint64_t KissatWrapper::getRedundantClauseBytes() { return kissat_get_redundant_bytes(solver); }
+void     KissatWrapper::setRedundantClauseLimit(uint64_t n) { kissat_set_redundant_limit(solver, n); }
+
 Model KissatWrapper::getModel() {
     Model model(num_vars);
-    for (int var=1; var <= (int)num_vars; var++) {        
-      int lit = kissat_value(solver, var);
-      if (lit)
-        model[var] = lit > 0;
-   }
-   return model;
+    model_values.resize(num_vars);
+    kissat_get_values(solver, model_values.data(), num_vars);
+    model.load(model_values.data(), [](signed char v) {
+        return v > 0 ? Model::TRUE_VALUE : v < 0 ? Model::FALSE_VALUE : Model::UNDEF_VALUE;
+    });
+    return model;
 }
 
 // copied from kissat/src/handle.c
@@ -13,8 +13,13 @@ class KissatWrapper : public AbstDetSeqSolver {
 private:
    kissat*  solver;
    uint32_t num_vars;
-   Clause   exp_tmp;
    double   exp_clause_lbd_lim;
+   // buffers to pass imported clauses to kissat in one batch
+   std::vector<int>          imp_units;
+   std::vector<const int *>  imp_clauses;
+   std::vector<unsigned>     imp_sizes;
+   // buffer to extract a model from kissat
+   std::vector<signed char>  model_values;
 
 public:   
    KissatWrapper(int id, Sharer *sharer, Options& options);
@@ -22,13 +27,20 @@ public:
 
    SATResult solve();
    bool loadFormula(const Instance& clauses);
+
+   // sets a parameter given by a diversification profile (only validates it if 'solver' is null)
+   static bool setParam(kissat *solver, const std::string& name, double value);
+   static bool isValidParam(const std::string& name, double value) { return setParam(nullptr, name, value); }
    void incExpClauseGen() { exp_clause_lbd_lim += 1.0 / exp_clause_lbd_lim; }
    void decExpClauseGen() { exp_clause_lbd_lim -= 1.0; exp_clause_lbd_lim = std::max(2.0, exp_clause_lbd_lim); }
 
    bool shouldBeExported(uint32_t lbd);
-   void uncheckedExportClause(const int *clause, uint32_t len, uint32_t lbd);
+   // kissat writes an exported clause of 'size' literals into the returned space and commits it
+   int* reserveExport(uint32_t size);
+   void commitExport();
 
    kissat* getKissatSolver() { return solver; }
+   bool    applyImportedClauses();
 
    // statistics methods
    uint64_t getNumConflicts();
@@ -37,6 +49,11 @@ public:
    uint64_t getNumRestarts();
    uint64_t getNumRedundantClauses();
    Model    getModel();
+
+   // memory estimators
+   uint64_t getMemoryFootprint();
+   uint64_t getRedundantClauseBytes();
+   void     setRedundantClauseLimit(uint64_t n);
    uint32_t getExpLBDthreshold() { return std::min(exp_clause_lbd_lim, getLBDUpperbound()); }
    char     getSolverState();
 };
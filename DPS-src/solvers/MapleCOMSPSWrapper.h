@@ -10,7 +10,6 @@ namespace DPS {
 class MapleCOMSPSWrapper : public AbstDetSeqSolver {
 private:
    MapleCOMSPS::SimpSolver* solver;
-   Clause               exp_tmp;
    double               exp_clause_lbd_lim;
    uint32_t             exp_clause_len_lim;
 
@@ -20,6 +19,11 @@ public:
 
    SATResult solve();
    bool loadFormula(const Instance& clauses);
+   bool supportsIncremental() const { return true; }
+
+   // sets a parameter given by a diversification profile (only validates it if 'solver' is null)
+   static bool setParam(MapleCOMSPS::SimpSolver *solver, const std::string& name, double value);
+   static bool isValidParam(const std::string& name, double value) { return setParam(nullptr, name, value); }
    void incExpClauseGen() { exp_clause_lbd_lim += 1.0 / exp_clause_lbd_lim; }
    void decExpClauseGen() { exp_clause_lbd_lim -= 1.0; exp_clause_lbd_lim = std::max(2.0, exp_clause_lbd_lim); }
 
@@ -32,6 +36,11 @@ public:
    uint64_t getNumRestarts();
    uint64_t getNumRedundantClauses();
    Model    getModel();
+
+   // memory estimators
+   uint64_t getMemoryFootprint();
+   uint64_t getRedundantClauseBytes();
+   void     setRedundantClauseLimit(uint64_t n);
    uint32_t getExpLBDthreshold() { return exp_clause_lbd_lim; }
 };
 
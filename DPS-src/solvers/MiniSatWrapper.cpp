@@ -1,11 +1,13 @@
 // Include files should be specified relatively to avoid confusion with same named files.
 #include "MiniSatWrapper.h"
+#include "SolverParams.h"
 
 using namespace DPS;
 using namespace Minisat;
 
 // Macros for minisat literal representation conversion
 #define INT_LIT(lit) sign(lit) ? -(var(lit) + 1) : (var(lit) + 1)
+#define SOLVER_LIT(n) ((n) > 0 ? mkLit((n) - 1) : ~mkLit(-(n) - 1))
 
 MiniSatWrapper::MiniSatWrapper(int id, Sharer *sharer, Options& options) : 
     AbstDetSeqSolver(id, sharer, options)
@@ -14,6 +16,11 @@ MiniSatWrapper::MiniSatWrapper(int id, Sharer *sharer, Options& options) :
     solver = new SimpSolver();
     if (!solver) throw std::runtime_error("could not allocate memory for Minisat::SimpSolver");
     solver->wrapper = this;
+    solver->prob_confs = options.getProbConfs();
+
+    // diversification strategy
+    for (const auto& p : options.getProfile().getParams("minisat", id))
+        setParam(solver, p.first, p.second);
     solver->random_seed += id;    
     if (id) solver->rand_pick_first_conflict = true;
 }
@@ -22,40 +29,58 @@ MiniSatWrapper::~MiniSatWrapper() {
     delete solver;
 }
 
+// Parameters that can be set by diversification profiles
+bool MiniSatWrapper::setParam(SimpSolver *solver, const std::string& name, double value) {
+    PARAM("var_decay",         var_decay,         0 < value && value < 1);
+    PARAM("clause_decay",      clause_decay,      0 < value && value < 1);
+    PARAM("random_var_freq",   random_var_freq,   0 <= value && value <= 1);
+    PARAM("random_seed",       random_seed,       0 < value);
+    PARAM("luby_restart",      luby_restart,      PARAM_BOOL(value));
+    PARAM("ccmin_mode",        ccmin_mode,        PARAM_INT(value) && 0 <= value && value <= 2);
+    PARAM("phase_saving",      phase_saving,      PARAM_INT(value) && 0 <= value && value <= 2);
+    PARAM("rnd_pol",           rnd_pol,           PARAM_BOOL(value));
+    PARAM("rnd_init_act",      rnd_init_act,      PARAM_BOOL(value));
+    PARAM("restart_first",     restart_first,     PARAM_INT(value) && 1 <= value);
+    PARAM("restart_inc",       restart_inc,       1 < value);
+    PARAM("learntsize_factor", learntsize_factor, 0 < value);
+    PARAM("learntsize_inc",    learntsize_inc,    1 <= value);
+    return false;
+}
+
+#undef PARAM_BOOL
+#undef PARAM_INT
+#undef PARAM
+
 SATResult MiniSatWrapper::solve() {
-    if (input_formula != nullptr) {
-        loadFormula(*input_formula);
-        input_formula = nullptr;
-    }
+    loadInputFormula();
 
-    vec<Lit> dummy;
+    vec<Lit> assumps;
+    for (int lit : assumptions) {
+        solver->newVars(std::abs(lit));
+        assumps.push(SOLVER_LIT(lit));
+    }
+    // variables are not eliminated if the solver is kept for the next call
+    bool do_simp = options.getMSSimp() && !incremental;
     parchrono.start(RunningTime);
-    lbool res = solver->solveLimited(dummy, options.getMSSimp(), true);
+    lbool res = solver->solveLimited(assumps, do_simp, true);
     parchrono.stop(RunningTime);
     SATResult result = UNKNOWN;
     if (res == l_True) 
         result = SAT;
-    else if (res == l_False)
+    else if (res == l_False) {
         result = UNSAT;
-    sharer->IFinished(result, periods, thn);
-    completeCurrPeriod();
-    pthread_cond_signal(pcfinished);
+        std::vector<int> core;
+        for (int i = 0; i < solver->conflict.size(); i++)
+            core.push_back(INT_LIT(solver->conflict[i]));
+        setFailedAssumptions(core);
+    }
+    finish(result);
     return result;
 }
 
 bool MiniSatWrapper::loadFormula(const Instance& clauses) {
-    vec<Lit> c;
-    for (auto clause : clauses) {
-        c.clear();
-        for (auto n : clause) {
-            Var v = abs(n) - 1;
-            while (v >= solver->nVars()) solver->newVar();
-            c.push(n > 0 ? mkLit(v) : ~mkLit(v));            
-        }
-        if (!solver->addClause(c))
-            return false;
-    }
-    return true;
+    solver->newVars(clauses.getNumVars());
+    return solver->addClauses(clauses.getLiterals(), clauses.getOffsets(), clauses.getNumClauses());
 }
 
 uint64_t MiniSatWrapper::getNumConflicts()    { return (uint64_t)solver->conflicts; }
@@ -64,15 +89,18 @@ uint64_t MiniSatWrapper::getNumPropagations() { return (uint64_t)solver->propaga
 uint64_t MiniSatWrapper::getNumRestarts()     { return (uint64_t)solver->starts; }
 uint64_t MiniSatWrapper::getNumRedundantClauses() { return (uint64_t)solver->nLearnts(); }
 
+uint64_t MiniSatWrapper::getMemoryFootprint()      { return solver->memoryUsage(); }
+uint64_t MiniSatWrapper::getRedundantClauseBytes() { return solver->redundantBytes(); }
+void     MiniSatWrapper::setRedundantClauseLimit(uint64_t n) { solver->setRedundantLimit(n); }
+
 Model MiniSatWrapper::getModel() {
     Model model(solver->nVars());
-    for (int i = 0; i < solver->nVars(); i++) {
-        if (solver->model[i] != l_Undef) {
-            bool val = solver->model[i] == l_True;
-            model[i+1] = val;
-        }
-    }
-   return model;
+    // l_True = 0, l_False = 1 and l_Undef = 2 (or 3)
+    model.load((const lbool *)solver->model, [](lbool v) {
+        uint8_t b = toInt(v);
+        return b & 2 ? Model::UNDEF_VALUE : b == 0 ? Model::TRUE_VALUE : Model::FALSE_VALUE;
+    });
+    return model;
 }
 
 void MiniSatWrapper::exportClause(vec<Lit>& cls) {
@@ -80,12 +108,10 @@ void MiniSatWrapper::exportClause(vec<Lit>& cls) {
 		return;
 
     parchrono.start(ExchangingTime);
-    // convert minisat's clause to DPS's clause
-    exp_tmp.clear();
+    // convert minisat's clause to DPS's clause directly in the export buffer
+    int *lits = exp_clauses_buf.reserve(cls.size(), cls.size());
     for (int i=0; i < cls.size(); i++) 
-        exp_tmp.push_back(INT_LIT(cls[i]));
-
-    // export clause
-    exp_clauses_buf.addClause(exp_tmp, exp_tmp.size());
+        lits[i] = INT_LIT(cls[i]);
+    exp_clauses_buf.commit();
     parchrono.stop(ExchangingTime);
 }
\ No newline at end of file
@@ -10,7 +10,6 @@ namespace DPS {
 class MiniSatWrapper : public AbstDetSeqSolver {
 private:
    Minisat::SimpSolver* solver;
-   Clause               exp_tmp;
    int                  exp_clause_len_lim;
 
 public:   
@@ -19,6 +18,11 @@ public:
 
    SATResult solve();
    bool loadFormula(const Instance& clauses);
+   bool supportsIncremental() const { return true; }
+
+   // sets a parameter given by a diversification profile (only validates it if 'solver' is null)
+   static bool setParam(Minisat::SimpSolver *solver, const std::string& name, double value);
+   static bool isValidParam(const std::string& name, double value) { return setParam(nullptr, name, value); }
 
    void exportClause(Minisat::vec<Minisat::Lit>& cls);
 
@@ -29,6 +33,11 @@ public:
    uint64_t getNumRestarts();
    uint64_t getNumRedundantClauses();
    Model    getModel();
+
+   // memory estimators
+   uint64_t getMemoryFootprint();
+   uint64_t getRedundantClauseBytes();
+   void     setRedundantClauseLimit(uint64_t n);
 };
 
 }
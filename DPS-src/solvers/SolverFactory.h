@@ -7,6 +7,7 @@
 // Include files should be specified relatively to avoid confusion with same named files.
 #include "AbstDetSeqSolver.h"
 #include "../parallel/Options.h"
+#include "../parallel/Portfolio.h"
 
 namespace DPS{
 
@@ -15,8 +16,20 @@ public:
     // Instantiate and return SAT solvers.
     static std::vector<AbstDetSeqSolver*> createSATSolvers(int num_solvers, Sharer *sharer, Options& options);
 
+    // Instantiate and return SAT solvers of a portfolio (the i-th solver has thread ID i).
+    static std::vector<AbstDetSeqSolver*> createSATSolvers(Portfolio& portfolio, Sharer *sharer);
+
     // Instantiate and return a SAT solver.
     static AbstDetSeqSolver* createSATSolver(std::string name, Sharer *sharer, Options& options);
+
+    // Instantiate and return a SAT solver with the specified id (e.g., a probe solver of the memory planner).
+    static AbstDetSeqSolver* createSATSolver(std::string name, Sharer *sharer, Options& options, int id);
+
+    static bool   isSolverName(const std::string& name);
+    // whether 'name' is a parameter of a base solver that accepts 'value' (used by diversification profiles)
+    static bool   isValidParam(const std::string& solver, const std::string& name, double value);
+    // # of memory accesses counted by a base solver per memory access of Kissat in the same time
+    static double getDefaultAccScale(const std::string& name);
 };
 
 }
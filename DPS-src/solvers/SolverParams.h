@@ -0,0 +1,11 @@
+#ifndef _DPS_SOLVER_PARAMS_H_
+#define _DPS_SOLVER_PARAMS_H_
+
+// Macros for 'setParam' of the wrappers of MiniSat-based solvers, which set parameters given by
+// diversification profiles. If 'name' is 'N', PARAM checks 'COND' on 'value' first and then sets
+// it to the member 'F' of 'solver' (if not null, otherwise the value is only validated).
+#define PARAM_BOOL(v)     ((v) == 0 || (v) == 1)
+#define PARAM_INT(v)      ((v) == (int)(v))
+#define PARAM(N, F, COND) if (name == N) { if (!(COND)) return false; if (solver) solver->F = value; return true; }
+
+#endif
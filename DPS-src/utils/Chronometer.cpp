@@ -1,51 +1,95 @@
 #include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <stdexcept>
 
 #include "Chronometer.h"
 
 using namespace DPS;
 
-void Chronometer::start(ProcName type) {
-    system_clock::time_point now = system_clock::now();
-    if (stack.size() > 0) {
-        ProcTime &pt = stack.back();
-        time[pt.type] += now - pt.start;
+std::string TimeHistogram::toString() const {
+    static const char *units[] = { "ns", "us", "ms", "s" };
+    std::string s;
+    char buf[64];
+    for (uint32_t i=0; i < NUM_BINS; i++) {
+        if (bins[i] == 0) continue;
+        uint64_t lb = lowerBound(i);
+        uint32_t u = 0;
+        while (u < 3 && lb >= 1000) { lb /= 1000; u++; }
+        snprintf(buf, sizeof(buf), "%s%" PRIu64 "%s:%" PRIu64, s.empty() ? "" : " ", lb, units[u], bins[i]);
+        s += buf;
     }
+    return s;
+}
+
+// The depth is checked in release builds too, since unbalanced start/stop calls would otherwise
+// write past 'stack'.
+inline void Chronometer::push(ProcName type, clock::time_point now) {
+    if (depth >= MAX_DEPTH)
+        throw std::runtime_error("Chronometer: processes are nested deeper than " + std::to_string(MAX_DEPTH));
     count[type]++;
-    stack.push_back(ProcTime(type, now));
+    stack[depth].type  = type;
+    stack[depth].start = now;
+    depth++;
 }
 
-void Chronometer::stop(ProcName type) {
-    system_clock::time_point now = system_clock::now();
-    ProcTime &pt = stack.back();
+inline void Chronometer::pop(ProcName type, clock::time_point now) {
+    if (depth == 0)
+        throw std::runtime_error("Chronometer: no process is running");
+    ProcTime &pt = stack[--depth];
     assert(pt.type == type);
+    (void)type;
     time[pt.type] += now - pt.start;
-    stack.pop_back();
-    if (stack.size() > 0) stack.back().start = now;
+    if (depth > 0) stack[depth - 1].start = now;
+}
+
+void Chronometer::start(ProcName type) {
+    clock::time_point now = clock::now();
+    if (depth > 0) {
+        ProcTime &pt = stack[depth - 1];
+        time[pt.type] += now - pt.start;
+    }
+    push(type, now);
+}
+
+void Chronometer::stop(ProcName type) {
+    pop(type, clock::now());
 }
 
 void Chronometer::toggle(ProcName from, ProcName to) {
-    system_clock::time_point now = system_clock::now();
-    // stop 'from' timer
-    ProcTime &pt = stack.back();
-    assert(pt.type == from);
-    time[pt.type] += now - pt.start;
-    stack.pop_back();
-    if (stack.size() > 0) stack.back().start = now;
-    // start 'to' timer
-    count[to]++;
-    stack.push_back(ProcTime(to, now));
+    clock::time_point now = clock::now();
+    pop(from, now);
+    push(to, now);
 }
 
 void Chronometer::stopAll() {
-    system_clock::time_point now = system_clock::now();
-    if (stack.size() > 0) {
-        ProcTime &pt = stack.back();
+    clock::time_point now = clock::now();
+    if (depth > 0) {
+        ProcTime &pt = stack[depth - 1];
         time[pt.type] += now - pt.start;
     }
-    stack.clear();
+    depth = 0;
 }
 
 void Chronometer::clearAll() {
-    for (size_t i=0; i < time.size(); i++)
-        time[i] = system_clock::duration(0);
+    for (int i=0; i < ProcTypes; i++) {
+        time[i] = clock::duration(0);
+        count[i] = 0;
+        prd_start_time[i] = clock::duration(0);
+        hist[i].clear();
+    }
+}
+
+void Chronometer::closePeriod() {
+    // the running process (if any) is accounted up to now
+    if (depth > 0) {
+        clock::time_point now = clock::now();
+        ProcTime &pt = stack[depth - 1];
+        time[pt.type] += now - pt.start;
+        pt.start = now;
+    }
+    for (int i=0; i < ProcTypes; i++) {
+        hist[i].add(duration_cast<nanoseconds>(time[i] - prd_start_time[i]).count());
+        prd_start_time[i] = time[i];
+    }
 }
@@ -3,6 +3,8 @@
 
 #include <chrono>
 #include <vector>
+#include <string>
+#include <algorithm>
 #include <cstdint>
 
 using namespace std::chrono;
@@ -18,34 +20,61 @@ enum ProcName {
     ProcTypes
 };
 
+// A log-scale histogram of durations. The i-th bin (i > 0) counts durations in [2^(i-1), 2^i) ns.
+class TimeHistogram {
+public:
+    static const uint32_t NUM_BINS = 64;
+private:
+    uint64_t bins[NUM_BINS];
+public:
+    TimeHistogram() { clear(); }
+    void     clear() { for (uint32_t i=0; i < NUM_BINS; i++) bins[i] = 0; }
+    void     add(uint64_t ns) { bins[ns == 0 ? 0 : std::min<uint32_t>(NUM_BINS - 1, 64 - __builtin_clzll(ns))]++; }
+    void     merge(const TimeHistogram& h) { for (uint32_t i=0; i < NUM_BINS; i++) bins[i] += h.bins[i]; }
+    uint64_t operator[](uint32_t i) const { return bins[i]; }
+    // lower bound of the i-th bin in ns
+    static uint64_t lowerBound(uint32_t i) { return i == 0 ? 0 : 1ULL << (i - 1); }
+    // non-empty bins, e.g., "1ms:3 2ms:10 4ms:1" (bins are labeled with their lower bounds)
+    std::string toString() const;
+};
+
+// Nested timers of processes of a thread. The time of an inner process is not counted as that of
+// an outer one. steady_clock is used since it is monotonic and cheap (vDSO) on Linux.
 class Chronometer {
 private:
+    typedef steady_clock            clock;
+    static const uint32_t           MAX_DEPTH = 8;
     struct ProcTime {
         ProcName                    type;
-        system_clock::time_point    start;
-        ProcTime(ProcName t, system_clock::time_point s) : type(t), start(s) {}
+        clock::time_point           start;
     };
-    std::vector<system_clock::duration> time;
-    std::vector<uint64_t>               count;
-    std::vector<ProcTime>               stack;
+    clock::duration                 time[ProcTypes];
+    uint64_t                        count[ProcTypes];
+    ProcTime                        stack[MAX_DEPTH];
+    uint32_t                        depth;
+    // time of each process in the current period and its distribution over periods
+    clock::duration                 prd_start_time[ProcTypes];
+    TimeHistogram                   hist[ProcTypes];
+
+    void push(ProcName type, clock::time_point now);
+    void pop (ProcName type, clock::time_point now);
 
 public:
-    Chronometer() {
-        time.resize(ProcTypes);
-        count.resize(ProcTypes);
-    };
+    Chronometer() : depth(0) { clearAll(); }
 
     void     start   (ProcName type);
     void     stop    (ProcName type);
     void     toggle  (ProcName from, ProcName to);
-    void     clear   (ProcName type) { time[type] = system_clock::duration(0); }
+    void     clear   (ProcName type) { time[type] = clock::duration(0); prd_start_time[type] = clock::duration(0); }
     void     clearAll();
     void     stopAll ();
-    double   getTime (ProcName type) { return static_cast<double>(duration_cast<nanoseconds>(time[type]).count()) / 1000000000; }
-    uint64_t getCount(ProcName type) { return count[type]; }
+    // records the time of each process spent from the end of the previous period
+    void     closePeriod();
+    double   getTime (ProcName type) const { return static_cast<double>(duration_cast<nanoseconds>(time[type]).count()) / 1000000000; }
+    uint64_t getCount(ProcName type) const { return count[type]; }
+    const TimeHistogram& getHistogram(ProcName type) const { return hist[type]; }
 };
 
 }
 
 #endif
-
@@ -0,0 +1,86 @@
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "PerfCounters.h"
+
+using namespace DPS;
+
+PerfCounters::PerfCounters() : num_open(0) {
+    for (int e = 0; e < NumEvents; e++)
+        fds[e] = -1;
+}
+
+const char* PerfCounters::getName(int e) {
+    static const char* names[NumEvents] = { "Cycles", "Instructions", "LLCMisses", "BranchMisses" };
+    return names[e];
+}
+
+#ifdef __linux__
+
+bool PerfCounters::open(std::string& error) {
+    static const uint64_t configs[NumEvents] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int e = 0; e < NumEvents; e++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = configs[e];
+        attr.disabled       = e == 0;       // the group starts when the leader is enabled
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP;
+        // the calling thread on any CPU
+        int fd = syscall(__NR_perf_event_open, &attr, 0, -1, e == 0 ? -1 : fds[0], 0);
+        if (fd < 0) {
+            // the leader (cycles) is required, the other events are optional (e.g., some VMs lack LLC events)
+            if (e == 0) {
+                error = std::string("perf_event_open failed: ") + strerror(errno);
+                return false;
+            }
+            continue;
+        }
+        fds[e] = fd;
+        num_open++;
+    }
+    ioctl(fds[0], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+void PerfCounters::close() {
+    for (int e = 0; e < NumEvents; e++) {
+        if (fds[e] >= 0) ::close(fds[e]);
+        fds[e] = -1;
+    }
+    num_open = 0;
+}
+
+bool PerfCounters::read(Sample& s) const {
+    memset(&s, 0, sizeof(s));
+    if (num_open == 0) return false;
+    // PERF_FORMAT_GROUP: the number of events followed by their values in the opened order
+    uint64_t buf[1 + NumEvents];
+    if (::read(fds[0], buf, sizeof(buf)) < (ssize_t)sizeof(uint64_t))
+        return false;
+    uint64_t k = 1;
+    for (int e = 0; e < NumEvents && k <= buf[0]; e++)
+        if (fds[e] >= 0)
+            s.values[e] = buf[k++];
+    return true;
+}
+
+#else
+
+bool PerfCounters::open(std::string& error) { error = "perf_event is only supported on Linux"; return false; }
+void PerfCounters::close() {}
+bool PerfCounters::read(Sample& s) const { memset(&s, 0, sizeof(s)); return false; }
+
+#endif
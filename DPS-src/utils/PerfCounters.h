@@ -0,0 +1,40 @@
+#ifndef _DPS_PERF_COUNTERS_H_
+#define _DPS_PERF_COUNTERS_H_
+
+#include <cstdint>
+#include <string>
+
+namespace DPS {
+
+// Hardware performance counters of the calling thread (Linux perf_event_open). The counters are
+// opened as one group, so they are scheduled together and read with one system call. If the
+// kernel does not allow them (e.g., perf_event_paranoid, containers), the counters stay closed.
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, LLCMisses, BranchMisses, NumEvents };
+    struct Sample {
+        uint64_t values[NumEvents];
+        uint64_t operator[](int e) const { return values[e]; }
+    };
+
+private:
+    int      fds[NumEvents];
+    int      num_open;
+
+public:
+    PerfCounters();
+    ~PerfCounters() { close(); }
+
+    // opens and starts the counters of the calling thread (returns false with 'error' on failure)
+    bool open(std::string& error);
+    void close();
+    bool isOpen() const { return num_open > 0; }
+    // reads the current values (events that could not be opened are 0)
+    bool read(Sample& s) const;
+
+    static const char* getName(int e);
+};
+
+}
+
+#endif
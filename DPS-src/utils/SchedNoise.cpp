@@ -0,0 +1,56 @@
+#include <thread>
+#include <chrono>
+
+// Include files should be specified relatively to avoid confusion with same named files.
+#include "SchedNoise.h"
+
+using namespace DPS;
+
+std::atomic<bool>     SchedNoise::enabled(false);
+std::atomic<uint64_t> SchedNoise::counter(0);
+uint64_t              SchedNoise::seed      = 0;
+uint32_t              SchedNoise::max_delay = 0;
+std::atomic<uint64_t> SchedNoise::num_delays[SchedNoise::NumPoints];
+
+void SchedNoise::enable(uint64_t s, uint32_t max_delay_us) {
+    seed      = s;
+    max_delay = max_delay_us;
+    counter   = 0;
+    for (int p = 0; p < NumPoints; p++)
+        num_delays[p] = 0;
+    enabled   = true;
+}
+
+void SchedNoise::disable() {
+    enabled = false;
+}
+
+void SchedNoise::delay(Point p) {
+    // splitmix64 of the seed and the # of calls
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (counter.fetch_add(1, std::memory_order_relaxed) + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z =  z ^ (z >> 31);
+
+    // a quarter of the calls sleep, another quarter yields, and the rest goes through
+    switch (z & 3) {
+    case 0:
+        num_delays[p].fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_for(std::chrono::microseconds((z >> 2) % (max_delay + 1)));
+        break;
+    case 1:
+        std::this_thread::yield();
+        break;
+    default:
+        break;
+    }
+}
+
+const char* SchedNoise::getName(Point p) {
+    switch (p) {
+    case PeriodEnd:    return "PeriodEnd";
+    case WaitAddition: return "WaitAddition";
+    case Finish:       return "Finish";
+    default:           return "Unknown";
+    }
+}
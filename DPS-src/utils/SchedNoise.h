@@ -0,0 +1,37 @@
+#ifndef _DPS_SCHED_NOISE_H_
+#define _DPS_SCHED_NOISE_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace DPS {
+
+// Random delays injected at synchronization points of threads (--sched-noise) to check that the
+// results do not depend on the timing of threads. The delays are drawn from one sequence
+// determined by the seed in the order of calls. Disabled noise costs one relaxed load per point.
+class SchedNoise {
+public:
+    enum Point { PeriodEnd, WaitAddition, Finish, NumPoints };
+
+private:
+    static std::atomic<bool>     enabled;
+    static std::atomic<uint64_t> counter;
+    static uint64_t              seed;
+    static uint32_t              max_delay;   // [us]
+    static std::atomic<uint64_t> num_delays[NumPoints];
+
+    static void delay(Point p);
+
+public:
+    // the noise is process-global, so each run enables or disables it explicitly
+    static void enable(uint64_t seed, uint32_t max_delay_us);
+    static void disable();
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void inject(Point p) { if (isEnabled()) delay(p); }
+    static uint64_t getNumDelays(Point p) { return num_delays[p].load(std::memory_order_relaxed); }
+    static const char* getName(Point p);
+};
+
+}
+
+#endif
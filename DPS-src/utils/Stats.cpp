@@ -0,0 +1,204 @@
+#include <cinttypes>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include "Stats.h"
+
+using namespace DPS;
+
+string StatsRecord::Value::toString() const {
+    char buf[64];
+    switch (type) {
+        case INT:  snprintf(buf, sizeof(buf), "%" PRId64, i);  return buf;
+        case REAL: snprintf(buf, sizeof(buf), "%.*f", prec, d); return buf;
+        case TEXT: return s;
+        default:   return "";
+    }
+}
+
+string StatsRecord::Value::toJSON() const {
+    switch (type) {
+        case INT:  return toString();
+        case REAL: return std::isfinite(d) ? toString() : "null";    // JSON has no nan or inf
+        case TEXT: {
+            string r = "\"";
+            for (char c : s) {
+                if (c == '"' || c == '\\') r += '\\';
+                if ((unsigned char)c < 0x20) { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", c); r += buf; continue; }
+                r += c;
+            }
+            return r + "\"";
+        }
+        default:   return "null";
+    }
+}
+
+StatsRecord::Value StatsRecord::Entry::getTotal() const {
+    Value sum;
+    for (const Value& v : values) {
+        if (v.type == Value::INT  && sum.type != Value::REAL) { sum.type = Value::INT; sum.i += v.i; }
+        if (v.type == Value::REAL) {
+            if (sum.type == Value::INT) sum.d = sum.i;
+            sum.type = Value::REAL;
+            sum.d += v.d;
+            sum.prec = std::max(sum.prec, v.prec);
+        }
+    }
+    return sum;
+}
+
+void StatsRecord::section(const string& name, uint32_t verbose) {
+    for (curr = 0; curr < sections.size(); curr++)
+        if (sections[curr].name == name) return;
+    sections.push_back(Section{ name, verbose, {}, {} });
+}
+
+StatsRecord::Entry& StatsRecord::entry(const string& key, bool per_thread, bool total) {
+    if (sections.empty()) section("");
+    Section& sec = sections[curr];
+    auto it = sec.index.find(key);
+    if (it != sec.index.end())
+        return sec.entries[it->second];
+    sec.index[key] = sec.entries.size();
+    sec.entries.push_back(Entry{ key, per_thread, total, {} });
+    return sec.entries.back();
+}
+
+void StatsRecord::set(const string& key, const Value& v) {
+    Entry& e = entry(key, false, false);
+    e.values.assign(1, v);
+}
+
+void StatsRecord::set(uint32_t thn, const string& key, const Value& v, bool total) {
+    Entry& e = entry(key, true, total);
+    if (e.values.size() <= thn) e.values.resize(thn + 1);
+    e.values[thn] = v;
+}
+
+bool StatsRecord::get(const string& name, Value& v) const {
+    for (const Section& sec : sections) {
+        for (const Entry& e : sec.entries) {
+            if (!e.per_thread) {
+                if (e.key != name) continue;
+                v = e.values[0];
+                return true;
+            }
+            if (name.size() <= e.key.size() + 1 || name.compare(0, e.key.size(), e.key) != 0 || name[e.key.size()] != '_')
+                continue;
+            const string suffix = name.substr(e.key.size() + 1);
+            if (suffix == "total" && e.total) {
+                v = e.getTotal();
+                return true;
+            }
+            if (suffix.size() > 9 || suffix.find_first_not_of("0123456789") != string::npos) continue;
+            size_t thn = std::stoul(suffix);
+            if (thn < e.values.size() && e.values[thn].type != Value::NONE) {
+                v = e.values[thn];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void StatsRecord::print(uint32_t verbose) const {
+    bool printed = false;
+    for (const Section& sec : sections) {
+        if (verbose < sec.verbose) continue;
+        printf("c\n");
+        printf("c [%s]\n", sec.name.c_str());
+        for (const Entry& e : sec.entries) {
+            if (!e.per_thread) {
+                printf("c %s : %s\n", e.key.c_str(), e.values[0].toString().c_str());
+                continue;
+            }
+            for (size_t i = 0; i < e.values.size(); i++)
+                if (e.values[i].type != Value::NONE)
+                    printf("c %s_%zu : %s\n", e.key.c_str(), i, e.values[i].toString().c_str());
+            if (e.total)
+                printf("c %s_total : %s\n", e.key.c_str(), e.getTotal().toString().c_str());
+        }
+        printed = true;
+    }
+    if (printed) printf("c\n");
+}
+
+void StatsRecord::writeJSON(FILE *fp, bool flat) const {
+    fprintf(fp, "{");
+    bool first_sec = true;
+    bool first = true;
+    for (const Section& sec : sections) {
+        if (!flat) {
+            fprintf(fp, "%s\"%s\":{", first_sec ? "" : ",", sec.name.c_str());
+            first = true;
+        }
+        first_sec = false;
+        for (const Entry& e : sec.entries) {
+            fprintf(fp, "%s\"%s\":", first ? "" : ",", e.key.c_str());
+            first = false;
+            if (!e.per_thread) {
+                fprintf(fp, "%s", e.values[0].toJSON().c_str());
+                continue;
+            }
+            fprintf(fp, "[");
+            for (size_t i = 0; i < e.values.size(); i++)
+                fprintf(fp, "%s%s", i ? "," : "", e.values[i].toJSON().c_str());
+            fprintf(fp, "]");
+            if (e.total)
+                fprintf(fp, ",\"%s_total\":%s", e.key.c_str(), e.getTotal().toJSON().c_str());
+        }
+        if (!flat) fprintf(fp, "}");
+    }
+    fprintf(fp, "}");
+}
+
+void StatsRecord::writeCSV(FILE *fp, const string& record) const {
+    auto quote = [](const string& s) {
+        if (s.find_first_of(",\"\n") == string::npos) return s;
+        string r = "\"";
+        for (char c : s) { if (c == '"') r += '"'; r += c; }
+        return r + "\"";
+    };
+    for (const Section& sec : sections) {
+        for (const Entry& e : sec.entries) {
+            if (!e.per_thread) {
+                fprintf(fp, "%s,%s,%s,,%s\n", record.c_str(), quote(sec.name).c_str(), e.key.c_str(), quote(e.values[0].toString()).c_str());
+                continue;
+            }
+            for (size_t i = 0; i < e.values.size(); i++)
+                if (e.values[i].type != Value::NONE)
+                    fprintf(fp, "%s,%s,%s,%zu,%s\n", record.c_str(), quote(sec.name).c_str(), e.key.c_str(), i, quote(e.values[i].toString()).c_str());
+            if (e.total)
+                fprintf(fp, "%s,%s,%s,total,%s\n", record.c_str(), quote(sec.name).c_str(), e.key.c_str(), quote(e.getTotal().toString()).c_str());
+        }
+    }
+}
+
+void StatsSink::write(const string& json_file, const string& csv_file, const StatsRecord& summary, const string& result) const {
+    if (!json_file.empty()) {
+        FILE *fp = fopen(json_file.c_str(), "w");
+        if (fp == NULL)
+            throw std::runtime_error("could not open stats file '" + json_file + "'");
+        fprintf(fp, "{\"result\":\"%s\",\n\"progress\":[", result.c_str());
+        for (size_t i = 0; i < progress.size(); i++) {
+            fprintf(fp, "%s\n", i ? "," : "");
+            progress[i].writeJSON(fp, true);
+        }
+        fprintf(fp, "],\n\"summary\":");
+        summary.writeJSON(fp, false);
+        fprintf(fp, "}\n");
+        fclose(fp);
+    }
+    if (!csv_file.empty()) {
+        FILE *fp = fopen(csv_file.c_str(), "w");
+        if (fp == NULL)
+            throw std::runtime_error("could not open stats file '" + csv_file + "'");
+        fprintf(fp, "record,section,key,thread,value\n");
+        for (size_t i = 0; i < progress.size(); i++)
+            progress[i].writeCSV(fp, "progress" + std::to_string(i));
+        summary.writeCSV(fp, "summary");
+        fprintf(fp, "summary,,Result,,%s\n", result.c_str());
+        fclose(fp);
+    }
+}
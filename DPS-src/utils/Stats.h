@@ -0,0 +1,94 @@
+#ifndef _DPS_STATS_H_
+#define _DPS_STATS_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace DPS {
+
+using std::string;
+
+// A record of named statistics grouped into sections. A value is global or belongs to a thread;
+// the values of a thread-wise key are printed as 'Key_i' and (unless disabled) 'Key_total'.
+// Solvers and the sharer report into a record (see reportStats), and the record is printed in the
+// 'c Key : value' format and written to the JSON/CSV sinks, so a new counter is added only in the
+// reporting method.
+class StatsRecord {
+public:
+    class Value {
+    public:
+        enum Type { NONE, INT, REAL, TEXT };
+        Type    type;
+        int64_t i;
+        double  d;
+        int     prec;   // # of digits after the decimal point of REAL values
+        string  s;
+        Value()                     : type(NONE), i(0), d(0), prec(0) {}
+        Value(int v)                : type(INT),  i(v), d(0), prec(0) {}
+        Value(unsigned v)           : type(INT),  i(v), d(0), prec(0) {}
+        Value(long v)               : type(INT),  i(v), d(0), prec(0) {}
+        Value(unsigned long v)      : type(INT),  i(v), d(0), prec(0) {}
+        Value(long long v)          : type(INT),  i(v), d(0), prec(0) {}
+        Value(unsigned long long v) : type(INT),  i(v), d(0), prec(0) {}
+        Value(double v, int p = 6)  : type(REAL), i(0), d(v), prec(p) {}
+        Value(const string& v)      : type(TEXT), i(0), d(0), prec(0), s(v) {}
+        Value(const char *v)        : type(TEXT), i(0), d(0), prec(0), s(v) {}
+        Value(char v)               : type(TEXT), i(0), d(0), prec(0), s(1, v) {}
+        string toString() const;
+        string toJSON()   const;
+    };
+
+    // selects the section 'name' (created if not exists) printed when the verbose level >= 'verbose'
+    void section(const string& name, uint32_t verbose = 1);
+    // sets a global value
+    void set(const string& key, const Value& v);
+    // sets the value of thread 'thn' (the total over threads is given unless 'total' is false)
+    void set(uint32_t thn, const string& key, const Value& v, bool total = true);
+
+    // finds the value printed as 'name' (e.g., 'RealTime', 'Conflicts_2' or 'Conflicts_total')
+    bool get(const string& name, Value& v) const;
+
+    // prints sections of which verbose level <= 'verbose' in the 'c Key : value' format
+    void print(uint32_t verbose) const;
+    // JSON object (sections are nested unless 'flat')
+    void writeJSON(FILE *fp, bool flat) const;
+    // CSV rows of 'record,section,key,thread,value'
+    void writeCSV(FILE *fp, const string& record) const;
+
+private:
+    struct Entry {
+        string             key;
+        bool               per_thread;
+        bool               total;
+        std::vector<Value> values;      // values[thn] for thread-wise keys, values[0] otherwise
+        Value              getTotal() const;
+    };
+    struct Section {
+        string                   name;
+        uint32_t                 verbose;
+        std::vector<Entry>       entries;
+        std::map<string, size_t> index;
+    };
+    std::vector<Section> sections;
+    size_t               curr = 0;
+
+    Entry& entry(const string& key, bool per_thread, bool total);
+};
+
+// Sinks of statistics in machine-readable formats (--stats-json and --stats-csv). Progress
+// records are collected at each log interval and written with the final record at the end.
+class StatsSink {
+    std::vector<StatsRecord> progress;
+
+public:
+    void addProgress(const StatsRecord& r) { progress.push_back(r); }
+    // writes all records to the files (unless empty), throws std::runtime_error if a file can not be opened
+    void write(const string& json_file, const string& csv_file, const StatsRecord& summary, const string& result) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include <cstdio>
+#include <cinttypes>
+#include <stdexcept>
+
+#include "Tracer.h"
+
+using namespace DPS;
+
+void Tracer::writeChromeTrace(const std::string& file, const std::vector<const Tracer*>& tracers, const std::vector<std::string>& thread_names) {
+    FILE *fp = fopen(file.c_str(), "w");
+    if (fp == NULL)
+        throw std::runtime_error("could not open trace file '" + file + "'");
+
+    // timestamps are relative to the earliest record
+    uint64_t origin = UINT64_MAX;
+    for (const Tracer *t : tracers) {
+        if (!t->periods.empty() && t->periods.front().start < origin) origin = t->periods.front().start;
+        if (!t->waits.empty()   && t->waits.front().start   < origin) origin = t->waits.front().start;
+    }
+    auto us = [origin](uint64_t ns) { return (double)(ns - origin) / 1000.0; };
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    auto sep = [&]() { if (!first) fprintf(fp, ",\n"); first = false; };
+    for (size_t i = 0; i < tracers.size(); i++) {
+        sep();
+        fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}", i, thread_names[i].c_str());
+        for (const PeriodRecord& r : tracers[i]->periods) {
+            sep();
+            fprintf(fp, "{\"name\":\"P%" PRIu64 "\",\"cat\":\"period\",\"ph\":\"X\",\"pid\":0,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"args\":{\"period\":%" PRIu64 ",\"conflicts\":%" PRIu64 ",\"exported\":%" PRIu64 ",\"imported\":%" PRIu64,
+                    r.period, i, us(r.start), (double)(r.end - r.start) / 1000.0, r.period, r.conflicts, r.exported, r.imported);
+            if (r.cycles > 0)
+                fprintf(fp, ",\"cycles\":%" PRIu64 ",\"instructions\":%" PRIu64 ",\"llc_misses\":%" PRIu64 ",\"branch_misses\":%" PRIu64,
+                        r.cycles, r.instructions, r.llc_misses, r.branch_misses);
+            fprintf(fp, "}}");
+        }
+        for (const WaitRecord& r : tracers[i]->waits) {
+            sep();
+            fprintf(fp, "{\"name\":\"wait T%u/P%" PRIu64 "\",\"cat\":\"wait\",\"ph\":\"X\",\"pid\":0,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"args\":{\"period\":%" PRIu64 ",\"producer\":%u,\"producer_period\":%" PRIu64 "}}",
+                    r.producer, r.producer_prd, i, us(r.start), (double)(r.end - r.start) / 1000.0, r.period, r.producer, r.producer_prd);
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+}
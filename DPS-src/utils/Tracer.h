@@ -0,0 +1,62 @@
+#ifndef _DPS_TRACER_H_
+#define _DPS_TRACER_H_
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace DPS {
+
+// Timeline of a solver thread for the analysis of stragglers (enabled by the 'trace' option).
+// Each thread appends records only to its own tracer, so no synchronization is needed while
+// solving. The tracers of all threads are written in the Chrome trace event format (which can
+// be opened by chrome://tracing and Perfetto) after all threads are finished.
+class Tracer {
+public:
+    // a period of the thread (from the end of the previous period to the end of this one)
+    struct PeriodRecord {
+        uint64_t period;
+        uint64_t start;         // [ns]
+        uint64_t end;           // [ns]
+        uint64_t conflicts;     // # of conflicts in the period
+        uint64_t exported;      // # of clauses exported at the end of the period
+        uint64_t imported;      // # of clauses received at the end of the period
+        // hardware counters in the period (0 unless the 'perf' option is given)
+        uint64_t cycles;
+        uint64_t instructions;
+        uint64_t llc_misses;
+        uint64_t branch_misses;
+    };
+    // a wait for the clauses of another thread
+    struct WaitRecord {
+        uint64_t period;        // period of the waiting thread
+        uint64_t start;         // [ns]
+        uint64_t end;           // [ns]
+        uint32_t producer;      // thread whose clauses were awaited
+        uint64_t producer_prd;  // period of the awaited clauses
+    };
+
+private:
+    bool                      enabled;
+    std::vector<PeriodRecord> periods;
+    std::vector<WaitRecord>   waits;
+
+public:
+    Tracer() : enabled(false) {}
+
+    void     enable()          { enabled = true; periods.reserve(1024); }
+    bool     isEnabled() const { return enabled; }
+    // monotonic time [ns] (common to all threads)
+    static uint64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+    void addPeriod(const PeriodRecord& r) { periods.push_back(r); }
+    void addWait  (const WaitRecord& r)   { waits.push_back(r); }
+
+    // writes the tracers of all threads (thread_names[i] is the name of the i-th thread)
+    static void writeChromeTrace(const std::string& file, const std::vector<const Tracer*>& tracers, const std::vector<std::string>& thread_names);
+};
+
+}
+
+#endif
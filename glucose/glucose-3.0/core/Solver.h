@@ -181,8 +181,20 @@ public:
 
     // added for DPS
     DPS::GlucoseWrapper *wrapper;    
-    bool applyImportedClauses();
-    bool applyImportedClause(DPS::Clause& c);
+    bool applyImportedClauses(CRef& confl);
+    bool applyImportedClause(DPS::Clause& c, CRef& confl, uint32_t src = 0);
+    void sortWatchCandidates(vec<Lit>& lits) const;
+    int  watchPriority(Lit p) const { return value(p) == l_True ? INT_MAX - level(var(p)) : value(p) == l_Undef ? INT_MAX / 2 : level(var(p)); }
+    uint64_t max_redundant;            // soft limit on # of redundant clauses given by the memory planner (0 for unlimited)
+    uint64_t next_redundant_reduce;    // # of redundant clauses that forces the next reduction
+    void     setRedundantLimit(uint64_t n) { max_redundant = next_redundant_reduce = n; }
+    void     updateRedundantLimit();
+    uint64_t memoryUsage() const;      // estimated bytes used by this solver
+    uint64_t redundantBytes() const;   // estimated bytes used by redundant clauses
+    struct ProbationClause { CRef cr; uint64_t deadline; };
+    vec<ProbationClause> probation;    // imported clauses on probation (in order of deadline)
+    uint64_t prob_confs;               // # of conflicts for which an imported clause is on probation (0 for no probation)
+    void     reviewProbation();
 
 protected:
     long curRestart;
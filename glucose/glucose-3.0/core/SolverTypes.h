@@ -141,8 +141,11 @@ class Clause {
       unsigned learnt    : 1;
       unsigned has_extra : 1;
       unsigned reloced   : 1;
-      unsigned lbd       : 26;
+      unsigned lbd       : 23;    // modified for DPS (26 bits originally)
       unsigned canbedel  : 1;
+      unsigned imported  : 1;     // added for DPS (imported clause on probation)
+      unsigned used      : 1;     // added for DPS (used as a conflict or a reason while on probation)
+      unsigned tagged    : 1;     // added for DPS (imported clause with the source thread in the last word)
       unsigned size      : 32;
       unsigned szWithoutSelectors : 32;
 
@@ -153,7 +156,7 @@ class Clause {
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     template<class V>
-    Clause(const V& ps, bool use_extra, bool learnt) {
+    Clause(const V& ps, bool use_extra, bool learnt, bool tagged = false) {
         header.mark      = 0;
         header.learnt    = learnt;
         header.has_extra = use_extra;
@@ -161,6 +164,9 @@ class Clause {
         header.size      = ps.size();
 	header.lbd = 0;
 	header.canbedel = 1;
+	header.imported = 0;    // added for DPS
+	header.used = 0;        // added for DPS
+	header.tagged = tagged; // added for DPS
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
 	
@@ -181,7 +187,9 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size];
+                                               if (header.tagged) data[header.size-i+header.has_extra] = data[header.size+header.has_extra];    // added for DPS
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
@@ -210,6 +218,14 @@ public:
     unsigned int        lbd    () const        { return header.lbd; }
     void setCanBeDel(bool b) {header.canbedel = b;}
     bool canBeDel() {return header.canbedel;}
+    // added for DPS
+    bool         imported    ()      const   { return header.imported; }
+    void         imported    (bool b)        { header.imported = b; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool b)        { header.used = b; }
+    bool         tagged      ()      const   { return header.tagged; }
+    uint32_t     source      ()      const   { assert(header.tagged); return data[header.size + header.has_extra].abs; }
+    void         source      (uint32_t s)    { assert(header.tagged); data[header.size + header.has_extra].abs = s; }
     void setSizeWithoutSelectors   (unsigned int n)              {header.szWithoutSelectors = n; }
     unsigned int        sizeWithoutSelectors   () const        { return header.szWithoutSelectors; }
 
@@ -223,8 +239,8 @@ public:
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 class ClauseAllocator : public RegionAllocator<uint32_t>
 {
-    static int clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    static int clauseWord32Size(int size, int extras){     // modified for DPS (# of extra words instead of 'has_extra')
+        return (sizeof(Clause) + (sizeof(Lit) * (size + extras))) / sizeof(uint32_t); }
  public:
     bool extra_clause_field;
 
@@ -236,14 +252,14 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         RegionAllocator<uint32_t>::moveTo(to); }
 
     template<class Lits>
-    CRef alloc(const Lits& ps, bool learnt = false)
+    CRef alloc(const Lits& ps, bool learnt = false, bool tagged = false)
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt);
+        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), (int)use_extra + (int)tagged));
+        new (lea(cid)) Clause(ps, use_extra, learnt, tagged);
 
         return cid;
     }
@@ -258,7 +274,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), (int)c.has_extra() + (int)c.tagged()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -267,7 +283,8 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         
         if (c.reloced()) { cr = c.relocation(); return; }
         
-        cr = to.alloc(c, c.learnt());
+        cr = to.alloc(c, c.learnt(), c.tagged());
+        if (c.tagged()) to[cr].source(c.source());     // added for DPS
         c.relocate(cr);
         
         // Copy extra data-fields: 
@@ -278,6 +295,8 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
 	  to[cr].setLBD(c.lbd());
 	  to[cr].setSizeWithoutSelectors(c.sizeWithoutSelectors());
 	  to[cr].setCanBeDel(c.canBeDel());
+	  to[cr].imported(c.imported());   // added for DPS
+	  to[cr].used(c.used());           // added for DPS
 	}
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
     }
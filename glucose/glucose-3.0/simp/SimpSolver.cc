@@ -91,6 +91,58 @@ Var SimpSolver::newVar(bool sign, bool dvar) {
 
 
 
+// added for DPS
+// Add variables up to 'n' at once. The capacities of per-variable vectors are reserved
+// in advance to avoid repeated reallocations. Variables are still initialized one by one
+// since the initial activities and the order of the heaps depend on the order of creation.
+void SimpSolver::newVars(int n)
+{
+    if (n <= nVars()) return;
+    assigns   .capacity(n);
+    vardata   .capacity(n);
+    activity  .capacity(n);
+    seen      .capacity(n);
+    polarity  .capacity(n);
+    decision  .capacity(n);
+    trail     .capacity(n);
+    frozen    .capacity(n);
+    eliminated.capacity(n);
+    if (use_simplification){
+        n_occ     .capacity(2 * n);
+        touched   .capacity(n);
+        occurs    .init(n - 1);
+    }
+    watches  .init(mkLit(n - 1, true));
+    watchesBin.init(mkLit(n - 1, true));
+    while (nVars() < n) newVar();
+}
+
+// Add clauses in DIMACS representation at once. The i-th clause consists of
+// lits[offsets[i]] ... lits[offsets[i+1]-1]. All variables must be added in advance.
+// The clause arena is reserved for all clauses at once (an upper bound since literals may be
+// removed), and the literals of each clause are converted in one reused buffer.
+bool SimpSolver::addClauses(const int* lits, const uint64_t* offsets, uint64_t num_clauses)
+{
+    uint64_t words = (num_clauses * (sizeof(Clause) + 2 * sizeof(Lit)) + (offsets[num_clauses] - offsets[0]) * sizeof(Lit)) / sizeof(uint32_t);
+    if (words < UINT32_MAX / 2 - ca.size())
+        ca.reserve((uint32_t)words);
+    if (num_clauses < INT32_MAX / 2)
+        clauses.capacity(clauses.size() + (int)num_clauses);
+
+    vec<Lit>& ps = add_tmp;
+    for (uint64_t i = 0; i < num_clauses; i++){
+        ps.clear();
+        for (uint64_t j = offsets[i]; j < offsets[i+1]; j++){
+            int n = lits[j];
+            ps.push(n > 0 ? mkLit(n - 1) : ~mkLit(-n - 1));
+        }
+        if (!addClause_(ps))
+            return false;
+    }
+    return true;
+}
+
+
 lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
 {
     vec<Var> extra_frozen;
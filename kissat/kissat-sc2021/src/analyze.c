@@ -11,6 +11,7 @@
 
 // added by nabesima for DPS
 #include "dps_api.h"
+#include "../../../DPS-src/solvers/DPS_C_API.h"
 
 #include <inttypes.h>
 
@@ -617,6 +618,11 @@ kissat_analyze (kissat * solver, clause * conflict)
     }
 
   START (analyze);
+  // added for DPS
+  if (solver->wrapper && solver->statistics.conflicts == 1)
+    DPS_recordFirstConflict (solver->wrapper);
+  if (conflict->size > 2 && conflict->source)	// added for DPS
+    DPS_useImportedClause (solver->wrapper, conflict->source - 1, 1);
   if (!solver->probing)
     {
       update_trail_average (solver);
@@ -27,10 +27,9 @@ kissat_learned_unit (kissat * solver, unsigned lit)
 
   // added by nabesima for DPS
   if (solver->wrapper && DPS_kissat_shouldBeExported(solver->wrapper, 1)) {
-    CLEAR_STACK (solver->export_clause);
-    const int elit = kissat_export_literal (solver, lit);
-    PUSH_STACK (solver->export_clause, elit);
-    DPS_kissat_uncheckedExportClause(solver->wrapper, BEGIN_STACK (solver->export_clause), 1, 1);
+    int *elits = DPS_kissat_reserveExport(solver->wrapper, 1);
+    elits[0] = kissat_export_literal (solver, lit);
+    DPS_kissat_commitExport(solver->wrapper);
   }
 }
 
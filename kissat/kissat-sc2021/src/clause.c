@@ -41,6 +41,8 @@ init_clause (kissat * solver, clause * res,
 
   res->garbage = false;
   res->hyper = false;
+  res->imported = false;	// added for DPS
+  res->source = 0;		// added for DPS
   res->keep = keep;
   res->reason = false;
   res->redundant = redundant;
@@ -10,15 +10,26 @@
 
 typedef struct clause clause;
 
-#define LD_MAX_GLUE 22u
+// modified for DPS (22u originally): 11 bits are taken for 'source' and 'imported' to keep
+// the header in 32 bits. Glues are clamped to MAX_GLUE = 2047 (see 'clause.c'), which is
+// above the largest 'tier1' and 'tier2' limits (100 and 1000), so the tiers are unchanged.
+// Only the reduction ranks clauses with glues above 2047 as equal and then by size.
+#define LD_MAX_GLUE 11u
 #define MAX_GLUE ((1u<<LD_MAX_GLUE)-1)
 
+// added for DPS (the source thread of an imported clause plus one, 0 for other clauses; threads
+// MAX_SOURCE-1 and above are counted as MAX_SOURCE-1)
+#define LD_MAX_SOURCE 10u
+#define MAX_SOURCE ((1u<<LD_MAX_SOURCE)-1)
+
 struct clause
 {
   unsigned glue:LD_MAX_GLUE;
+  unsigned source:LD_MAX_SOURCE;	// added for DPS
 
   bool garbage:1;
   bool hyper:1;
+  bool imported:1;		// added for DPS (imported clause on probation)
   bool keep:1;
   bool reason:1;
   bool redundant:1;
@@ -2,6 +2,7 @@
 #include "inline.h"
 #include "promote.h"
 #include "strengthen.h"
+#include "../../../DPS-src/solvers/DPS_C_API.h"
 
 static inline void
 mark_clause_as_used (kissat * solver, clause * c)
@@ -123,6 +124,8 @@ kissat_deduce_first_uip_clause (kissat * solver, clause * conflict)
 		analyze_literal (solver, all_assigned, frames, lit))
 	      unresolved_on_current_level++;
 	  mark_clause_as_used (solver, reason);
+	  if (reason->source)	// added for DPS
+	    DPS_useImportedClause (solver->wrapper, reason->source - 1, 0);
 	}
       assert (unresolved_on_current_level > 0);
       unresolved_on_current_level--;
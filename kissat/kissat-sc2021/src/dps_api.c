@@ -9,6 +9,9 @@
 #include "propsearch.h"
 #include "literal.h"
 #include "options.h"
+#include "flags.h"
+#include "allocate.h"
+#include "extend.h"
 #include "../../../DPS-src/solvers/DPS_C_API.h"
 #include "../../../DPS-src/solvers/ThreadLocalVars.h"
 
@@ -17,6 +20,21 @@ void kissat_set_wrapper(kissat *solver, void *wrapper, int thn) {
     solver->thn = thn;
 }
 
+void kissat_set_probation(kissat *solver, bool probation) {
+    solver->dps_probation = probation;
+}
+
+// Returns whether 'name' is an option and 'value' is in its range.
+bool kissat_is_valid_option(const char *name, int value) {
+#ifndef NOPTIONS
+    const opt *o = kissat_options_has (name);
+    return o && o->low <= value && value <= o->high;
+#else
+    (void) name, (void) value;
+    return false;
+#endif
+}
+
 void kissat_rand_pick_until_1st_conf(kissat *solver, int use) {
     solver->rand_pick_until_1st_conf = use;
 }
@@ -29,9 +47,19 @@ void kissat_forced_restart(kissat *solver) {
     kissat_backtrack_in_consistent_state (solver, 0);
 }
 
-int kissat_add_imported_unit_clause(kissat *solver, int elit) {
-    if (solver->inconsistent)
-        return -1;
+// Asserts a unit at the root level. Kissat allows out-of-order assignments on the trail,
+// so the solver backtracks only if the literal is already assigned at a non-root level.
+static void dps_assign_imported_unit(kissat *solver, unsigned ilit) {
+    if (VALUE (ilit)) {
+        assert (LEVEL (ilit) > 0);
+        kissat_backtrack_without_updating_phases (solver, LEVEL (ilit) - 1);
+    }
+    kissat_learned_unit (solver, ilit);
+}
+
+// Returns -1 if the unit is falsified at the root level, +1 if it is satisfied or can not be
+// added, 0 otherwise.
+static int dps_import_unit(kissat *solver, int elit) {
     kissat_require_valid_external_internal (elit);
     unsigned ilit = kissat_import_literal (solver, elit);
     if (ilit == INVALID_LIT)
@@ -43,16 +71,29 @@ int kissat_add_imported_unit_clause(kissat *solver, int elit) {
         return +1;
     if (value < 0)  // falsified
         return -1;
-    kissat_learned_unit (solver, ilit);
-    (void)kissat_search_propagate (solver);
-    return solver->inconsistent ? -1: 0;
+    dps_assign_imported_unit (solver, ilit);
+    return 0;
+}
+
+// Priority of a literal to be watched: true literals in increasing order of decision level,
+// unassigned literals and then false literals in decreasing order of decision level.
+static unsigned dps_watch_priority(kissat *solver, unsigned lit) {
+    const value value = VALUE (lit);
+    if (value > 0) return UINT_MAX - LEVEL (lit);
+    if (value == 0) return UINT_MAX / 2;
+    return LEVEL (lit);
 }
 
-int kissat_add_imported_clause(kissat *solver, const int *clause, unsigned size) {
+// Adds an imported clause at the current decision level. The two best watch candidates 
+// are moved to the front. If the clause is unit under the current trail, its literal is 
+// assigned at the level of the second watch (also if it is satisfied only above that level).
+// If it is falsified, it is stored in 'solver->dps_conflict' to be analyzed (the analysis
+// backtracks to the conflict level). A clause shrunk to an assigned unit is deferred to the
+// imported unit clauses of the wrapper, which are forced at most once every 'fapp-periods'.
+// A large clause is tagged with its source thread to count its uses (see 'deduce.c' and 
+// 'reduce.c'). With probation, it is also reviewed at the next reduction (see 'collect_reducibles').
+static int dps_import_clause(kissat *solver, const int *clause, unsigned size, unsigned source) {
     assert (EMPTY_STACK (solver->clause));
-    if (solver->inconsistent)
-        return -1;
-    
     const int *p = clause;
     const int *const end = clause + size;
     for (; p != end; p++) {
@@ -77,20 +118,228 @@ int kissat_add_imported_clause(kissat *solver, const int *clause, unsigned size)
     }
 
     size = SIZE_STACK (solver->clause);
-    if (size == 0)  // empty clause
+    if (size == 0) {  // empty clause
+        CLEAR_STACK (solver->clause);
         return -1;
+    }
     if (size == 1) {
-        kissat_learned_unit (solver, PEEK_STACK (solver->clause, 0));
-        (void)kissat_search_propagate (solver);
+        const unsigned unit = PEEK_STACK (solver->clause, 0);
+        CLEAR_STACK (solver->clause);
+        if (VALUE (unit)) {     // would force a backtrack
+            DPS_deferImportedUnit (solver->wrapper, kissat_export_literal (solver, unit));
+            return +1;
+        }
+        dps_assign_imported_unit (solver, unit);
+        return 0;
     }
-    else
-        kissat_new_redundant_clause (solver, size - 1);
 
+    unsigned *lits = BEGIN_STACK (solver->clause);
+    for (unsigned i = 0; i < 2; i++) {
+        unsigned best = i;
+        for (unsigned j = i + 1; j < size; j++)
+            if (dps_watch_priority (solver, lits[j]) > dps_watch_priority (solver, lits[best]))
+                best = j;
+        SWAP (unsigned, lits[i], lits[best]);
+    }
+    const unsigned first = lits[0], second = lits[1];
+    const reference ref = kissat_new_redundant_clause (solver, size - 1);
     CLEAR_STACK (solver->clause);
-    
+    struct clause *c = size == 2 ? 0 : kissat_dereference_clause (solver, ref);
+    if (c)
+        c->source = MIN (source, MAX_SOURCE - 1) + 1;
+    if (c && solver->dps_probation) {
+        c->imported = true;
+        c->keep = false;    // reducible while on probation
+        if (solver->first_reducible == INVALID_REF)
+            solver->first_reducible = ref;
+    }
+
+    if (VALUE (second) < 0) {
+        if (VALUE (first) > 0 && LEVEL (first) > LEVEL (second))
+            kissat_backtrack_without_updating_phases (solver, LEVEL (second));
+        const value value = VALUE (first);
+        if (value == 0) {   // unit under the current trail
+            if (size == 2)
+                kissat_assign_binary (solver, true, first, second);
+            else {
+                kissat_assign_reference (solver, first, ref, c);
+                if (c->imported) c->used = 1;
+            }
+        }
+        else if (value < 0) {   // falsified
+            solver->dps_conflict = size == 2 ? kissat_binary_conflict (solver, true, first, second) : c;
+            return 2;
+        }
+    }
+    return 0;
+}
+
+// Imports a batch of units and clauses. Units are asserted at the root level first, then
+// the clauses are added at the current decision level until one of them is falsified.
+// Nothing is propagated here: all imported literals are propagated at once by the next
+// 'kissat_search_propagate' in the search loop, which also reports conflicts among them
+// (a conflict at the root level makes the solver inconsistent in the analysis).
+int kissat_import_clauses(kissat *solver, dps_import_batch *batch) {
+    batch->applied = batch->imported = 0;
+    batch->backtracked = false;
+    if (solver->inconsistent)
+        return -1;
+
+    const unsigned level = solver->level;
+    for (unsigned i = 0; i < batch->num_units; i++) {
+        int res = dps_import_unit (solver, batch->units[i]);
+        if (res > 0)    // satisfied
+            continue;
+        batch->imported++;
+        if (res < 0)
+            return -1;
+    }
+    batch->backtracked = solver->level < level;
+
+    while (batch->applied < batch->num_clauses) {
+        const unsigned i = batch->applied++;
+        int res = dps_import_clause (solver, batch->clauses[i], batch->sizes[i], batch->sources[i]);
+        if (res > 0)    // satisfied or deferred
+            continue;
+        batch->imported++;
+        if (res < 0)
+            return -1;
+        if (res == 2)
+            return 2;
+    }
+    return 0;
+}
+
+// Adds all original clauses in one pass. The i-th clause consists of the literals
+// lits[offsets[i]] ... lits[offsets[i+1]-1] (DIMACS representation without terminating zeros).
+// Compared with calling 'kissat_add' for each literal, this function avoids per-literal API
+// checks and reserves the arena for all large clauses in advance. Root-level units are
+// propagated when they are added as in 'kissat_add'.
+int kissat_add_clauses(kissat *solver, const int *lits, const uint64_t *offsets, uint64_t num_clauses) {
+    kissat_require_initialized (solver);
+    kissat_require (!GET (searches), "incremental solving not supported");
+    assert (EMPTY_STACK (solver->clause));
+
+    // reserve the arena for large clauses (an upper bound since literals may be removed)
+    size_t words = SIZE_STACK (solver->arena);
+    for (uint64_t i = 0; i < num_clauses; i++) {
+        const uint64_t size = offsets[i + 1] - offsets[i];
+        if (size > 2)
+            words += kissat_bytes_of_clause (size) / sizeof (ward);
+    }
+    if (words <= MAX_ARENA)
+        while (CAPACITY_STACK (solver->arena) < words)
+            kissat_stack_enlarge (solver, (chars *) & solver->arena, sizeof (ward));
+
+    value *marks = solver->marks;
+    for (uint64_t i = 0; i < num_clauses && !solver->inconsistent; i++) {
+        const int *p = lits + offsets[i];
+        const int *const end = lits + offsets[i + 1];
+        bool satisfied = false;
+        bool trivial = false;
+        for (; p != end; p++) {
+            const int elit = *p;
+            kissat_require_valid_external_internal (elit);
+            const unsigned ilit = kissat_import_literal (solver, elit);
+            marks = solver->marks;      // importing may resize the marks
+            const value mark = marks[ilit];
+            if (mark > 0)               // duplicated literal
+                continue;
+            if (mark < 0) {             // dual literal
+                trivial = true;
+                break;
+            }
+            const value value = kissat_fixed (solver, ilit);
+            if (value > 0) {
+                satisfied = true;
+                break;
+            }
+            if (value < 0)
+                continue;
+            marks[ilit] = 1;
+            marks[NOT (ilit)] = -1;
+            PUSH_STACK (solver->clause, ilit);
+        }
+        const unsigned isize = SIZE_STACK (solver->clause);
+        unsigned *ilits = BEGIN_STACK (solver->clause);
+        for (unsigned j = 0; j < isize; j++)
+            marks[ilits[j]] = marks[NOT (ilits[j])] = 0;
+        if (!satisfied && !trivial) {
+            kissat_activate_literals (solver, isize, ilits);
+            if (isize == 0)
+                solver->inconsistent = true;
+            else if (isize == 1) {
+                kissat_original_unit (solver, ilits[0]);
+                // propagated immediately as in 'kissat_add'
+                if (!solver->level)
+                    (void) kissat_search_propagate (solver);
+            } else
+                (void)kissat_new_original_clause (solver);
+        }
+        CLEAR_STACK (solver->clause);
+    }
+
     return solver->inconsistent ? -1 : 0;
 }
 
+// memory estimation and clause database limit
+uint64_t kissat_get_memory_usage(kissat *solver) {
+    // per-variable arrays (assignments, flags, links, marks, values, phases, watch vectors, heap and trail)
+    const uint64_t bytes_per_var = sizeof (assigned) + sizeof (flags) + sizeof (links)
+        + 2 * (sizeof (mark) + sizeof (value) + sizeof (watches))
+        + 4 * sizeof (value) + sizeof (double) + 2 * sizeof (unsigned);
+    uint64_t bytes = (uint64_t) solver->size * bytes_per_var;
+    bytes += CAPACITY_STACK (solver->arena) * sizeof (ward);
+    bytes += CAPACITY_STACK (solver->vectors.stack) * sizeof (unsigned);
+    return bytes;
+}
+
+uint64_t kissat_get_redundant_bytes(kissat *solver) {
+    uint64_t bytes = 0;
+    for (all_clauses (c)) {
+        if (c->garbage || !c->redundant)
+            continue;
+        // each large clause is watched by two large watches (two words each)
+        bytes += kissat_bytes_of_clause (c->size) + 4 * sizeof (watch);
+    }
+    return bytes;
+}
+
+void kissat_set_redundant_limit(kissat *solver, uint64_t limit) {
+    solver->dps_max_redundant = limit;
+    solver->dps_next_reduce   = limit;
+}
+
+void kissat_update_redundant_limit(kissat *solver) {
+    // keep a gap of 'max/2' clauses between forced reductions if the database can not be reduced enough
+    uint64_t max = solver->dps_max_redundant;
+    if (max == 0)
+        return;
+    uint64_t next = solver->statistics.clauses_redundant + max / 2;
+    solver->dps_next_reduce = next < max ? max : next;
+}
+
+// Writes the values of external variables 1 ... 'max_var' into 'values' (values[v-1] is 1, -1 or
+// 0 if the variable v is true, false or unassigned), which is the same as kissat_value() for each
+// variable but extends the model and looks up the import table only once.
+void kissat_get_values(kissat *solver, signed char *values, unsigned max_var) {
+  if (!solver->extended && !EMPTY_STACK (solver->extend))
+    kissat_extend (solver);
+  const unsigned size = SIZE_STACK (solver->import);
+  const import *const imports = BEGIN_STACK (solver->import);
+  const value *const eliminated = BEGIN_STACK (solver->eliminated);
+  const value *const vals = solver->values;
+  for (unsigned eidx = 1; eidx <= max_var; eidx++) {
+    value tmp = 0;
+    if (eidx < size) {
+      const import *const import = imports + eidx;
+      if (import->imported)
+        tmp = import->eliminated ? eliminated[import->lit] : vals[import->lit];
+    }
+    values[eidx - 1] = tmp;
+  }
+}
+
 // statistics
 uint64_t kissat_get_num_conflicts(kissat *solver)    { return solver->statistics.conflicts; }
 uint64_t kissat_get_num_decisions(kissat *solver)    { return solver->statistics.decisions; }
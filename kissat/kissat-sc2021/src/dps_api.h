@@ -8,11 +8,35 @@
 
 void kissat_set_wrapper(kissat *solver, void *wrapper, int thn);
 int  kissat_set_option(kissat *solver, const char *name, int new_value); // defined in internal.c
+bool kissat_is_valid_option(const char *name, int value);
 void kissat_rand_pick_until_1st_conf(kissat *solver, int use);
 unsigned int kissat_get_decision_level(kissat *solver);
 void kissat_forced_restart(kissat *solver);
-int kissat_add_imported_unit_clause(kissat *solver, int elit);
-int kissat_add_imported_clause(kissat *solver, const int *clause, unsigned size);
+
+// A batch of imported clauses. Units are given as literals and the other clauses as 
+// pointers to their literals (DIMACS representation without terminating zeros).
+typedef struct dps_import_batch dps_import_batch;
+struct dps_import_batch {
+    const int        *units;
+    unsigned          num_units;
+    const int *const *clauses;
+    const unsigned   *sizes;
+    const unsigned   *sources;      // source thread of each clause
+    unsigned          num_clauses;
+    // results
+    unsigned          applied;      // # of consumed clauses (the rest follows a falsified one)
+    unsigned          imported;     // # of units and clauses not satisfied at the root level
+    bool              backtracked;  // whether the units forced backtracking
+};
+int kissat_import_clauses(kissat *solver, dps_import_batch *batch);   // returns -1 if inconsistent, 2 if falsified
+void kissat_set_probation(kissat *solver, bool probation);
+int kissat_add_clauses(kissat *solver, const int *lits, const uint64_t *offsets, uint64_t num_clauses);
+
+// memory estimation and clause database limit
+uint64_t kissat_get_memory_usage(kissat *solver);
+uint64_t kissat_get_redundant_bytes(kissat *solver);
+void     kissat_set_redundant_limit(kissat *solver, uint64_t limit);
+void     kissat_update_redundant_limit(kissat *solver);
 
 // statistics
 uint64_t kissat_get_num_conflicts(kissat *solver);
@@ -21,6 +45,7 @@ uint64_t kissat_get_num_propagations(kissat *solver);
 uint64_t kissat_get_num_restarts(kissat *solver);
 uint64_t kissat_get_num_redudants(kissat *solver);
 char     kissat_get_solver_state(kissat *solver);
+void     kissat_get_values(kissat *solver, signed char *values, unsigned max_var);
 
 bool dps_check_period(kissat *solver, const char *msg);
 
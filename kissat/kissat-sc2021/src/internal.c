@@ -53,7 +53,6 @@ kissat_init (void)
   solver->should_be_terminated = false;
   solver->rand_pick_until_1st_conf = false;
   solver->dps_ticks = 0;
-  INIT_STACK (solver->export_clause);
 
   return solver;
 }
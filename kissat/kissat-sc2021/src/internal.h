@@ -259,7 +259,10 @@ struct kissat
   bool     should_be_terminated;
   bool     rand_pick_until_1st_conf;
   uint64_t dps_ticks;
-  ints     export_clause;
+  clause*  dps_conflict;        // falsified imported clause to be analyzed
+  bool     dps_probation;       // imported large clauses are on probation until the next reduction
+  uint64_t dps_max_redundant;   // soft limit on # of redundant clauses (0 for unlimited)
+  uint64_t dps_next_reduce;     // # of redundant clauses that forces the next reduction
 };
 
 #define VARS (solver->vars)
@@ -146,15 +146,14 @@ kissat_learn_clause (kissat * solver)
   // unit clauses are exported in kissat_learned_unit
   if (solver->wrapper && SIZE_STACK (solver->clause) > 1) {
     if (DPS_kissat_shouldBeExported(solver->wrapper, glue)) {
-      CLEAR_STACK (solver->export_clause);
+      // literals are written directly into the export buffer of the wrapper
+      assert(SIZE_STACK (solver->clause) == size);
+      int *elits = DPS_kissat_reserveExport(solver->wrapper, size);
       unsigned *lits = BEGIN_STACK (solver->clause);
       const unsigned *const end = END_STACK (solver->clause);
-      for (unsigned *p = lits; p != end; p++) {
-        const int elit = kissat_export_literal (solver, *p);
-        PUSH_STACK (solver->export_clause, elit);
-      }
-      assert(SIZE_STACK (solver->export_clause) == size);
-      DPS_kissat_uncheckedExportClause(solver->wrapper, BEGIN_STACK (solver->export_clause), size, glue);
+      for (unsigned *p = lits; p != end; p++)
+        *elits++ = kissat_export_literal (solver, *p);
+      DPS_kissat_commitExport(solver->wrapper);
     }
   }
 
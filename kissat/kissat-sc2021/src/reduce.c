@@ -6,6 +6,8 @@
 #include "rank.h"
 #include "report.h"
 #include "trail.h"
+#include "dps_api.h"
+#include "../../../DPS-src/solvers/DPS_C_API.h"
 
 #include <inttypes.h>
 #include <math.h>
@@ -17,7 +19,9 @@ kissat_reducing (kissat * solver)
     return false;
   if (!solver->statistics.clauses_redundant)
     return false;
-  if (CONFLICTS < solver->limits.reduce.conflicts)
+  // modified for DPS (the redundant clause limit given by the memory planner forces a reduction)
+  if (CONFLICTS < solver->limits.reduce.conflicts
+      && !(solver->dps_max_redundant && REDUNDANT_CLAUSES >= solver->dps_next_reduce))
     return false;
   return true;
 }
@@ -37,6 +41,14 @@ struct reducible
 typedef STACK (reducible) reducibles;
 // *INDENT-ON*
 
+// added for DPS (counts an imported clause surviving a reduction)
+static inline void
+retain_imported_clause (kissat * solver, clause * c)
+{
+  if (c->source)
+    DPS_retainImportedClause (solver->wrapper, c->source - 1);
+}
+
 static bool
 collect_reducibles (kissat * solver, reducibles * reds, reference start_ref)
 {
@@ -76,7 +88,10 @@ collect_reducibles (kissat * solver, reducibles * reds, reference start_ref)
       if (c->garbage)
 	continue;
       if (c->reason)
-	continue;
+	{
+	  retain_imported_clause (solver, c);	// added for DPS
+	  continue;
+	}
       if (c->hyper)
 	{
 	  assert (c->size == 3);
@@ -96,13 +111,34 @@ collect_reducibles (kissat * solver, reducibles * reds, reference start_ref)
 	    }
 	  continue;
 	}
+      // added for DPS (an imported clause on probation is promoted if it has been used
+      // as a conflict or a reason since it was imported, otherwise evicted; the analysis
+      // marks it in 'mark_clause_as_used' since it is not kept while on probation)
+      if (c->imported)
+	{
+	  c->imported = false;
+	  if (!c->used)
+	    {
+	      DPS_evictImportedClause (solver->wrapper, c->source - 1);
+	      kissat_mark_clause_as_garbage (solver, c);
+	      continue;
+	    }
+	  c->keep = (c->glue <= (unsigned) GET_OPTION (tier1));
+	  DPS_promoteImportedClause (solver->wrapper, c->source - 1);
+	}
       if (c->keep)
-	continue;
+	{
+	  retain_imported_clause (solver, c);	// added for DPS
+	  continue;
+	}
       if (c->used)
 	{
 	  c->used--;
 	  if (c->glue <= tier2)
-	    continue;
+	    {
+	      retain_imported_clause (solver, c);	// added for DPS
+	      continue;
+	    }
 	}
       assert (!c->garbage);
       assert (kissat_clause_in_arena (solver, c));
@@ -174,6 +210,9 @@ mark_less_useful_clauses_as_garbage (kissat * solver, reducibles * reds)
       kissat_mark_clause_as_garbage (solver, c);
       reduced++;
     }
+  // added for DPS (the rest of reducible clauses survive)
+  for (const reducible * p = begin + reduced; p != end; p++)
+    retain_imported_clause (solver, (clause *) (arena + p->ref));
   ADD (clauses_reduced, reduced);
 }
 
@@ -249,6 +288,7 @@ kissat_reduce (kissat * solver)
   else
     kissat_phase (solver, "reduce", GET (reductions), "nothing to reduce");
   UPDATE_CONFLICT_LIMIT (reduce, reductions, SQRT, false);
+  kissat_update_redundant_limit (solver);   // added for DPS
   REPORT (0, '-');
   STOP (reduce);
   return solver->inconsistent ? 20 : 0;
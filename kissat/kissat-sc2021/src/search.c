@@ -172,6 +172,14 @@ dps_apply_imported_clauses(kissat *solver) {
   return DPS_kissat_applyImportedClauses(wrapper);
 }
 
+// added for DPS (returns a falsified imported clause)
+static clause *
+dps_imported_conflict (kissat *solver) {
+  clause *conflict = solver->dps_conflict;
+  solver->dps_conflict = 0;
+  return conflict;
+}
+
 int
 kissat_search (kissat * solver)
 {
@@ -187,7 +195,9 @@ kissat_search (kissat * solver)
 	break;
       }
 
-      clause *conflict = kissat_search_propagate (solver);
+      clause *conflict = dps_imported_conflict (solver);  // modified for DPS
+      if (!conflict)
+        conflict = kissat_search_propagate (solver);
       if (conflict)
 	res = kissat_analyze (solver, conflict);
       else if (solver->iterating)
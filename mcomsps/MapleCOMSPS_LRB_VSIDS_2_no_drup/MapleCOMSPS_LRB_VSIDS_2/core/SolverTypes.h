@@ -135,8 +135,11 @@ class Clause {
         unsigned learnt    : 1;
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned lbd       : 26;
+        unsigned lbd       : 23;    // modified for DPS (26 bits originally)
         unsigned removable : 1;
+        unsigned imported  : 1;     // added for DPS (imported clause on probation)
+        unsigned used      : 1;     // added for DPS (used as a conflict or a reason while on probation)
+        unsigned tagged    : 1;     // added for DPS (imported clause with the source thread in the last word)
         unsigned size      : 32; }                            header;
     union { Lit lit; float act; uint32_t abs; uint32_t touched; CRef rel; } data[0];
 
@@ -144,7 +147,7 @@ class Clause {
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     template<class V>
-    Clause(const V& ps, bool use_extra, bool learnt) {
+    Clause(const V& ps, bool use_extra, bool learnt, bool tagged = false) {
         header.mark      = 0;
         header.learnt    = learnt;
         header.has_extra = learnt | use_extra;
@@ -152,6 +155,9 @@ class Clause {
         header.size      = ps.size();
         header.lbd       = 0;
         header.removable = 1;
+        header.imported  = 0;       // added for DPS
+        header.used      = 0;       // added for DPS
+        header.tagged    = tagged;  // added for DPS
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -174,7 +180,9 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size];
+                                               if (header.tagged) data[header.size-i+extras()] = data[header.size+extras()];    // added for DPS
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
@@ -190,6 +198,15 @@ public:
     void         set_lbd     (int lbd)       { header.lbd = lbd; }
     bool         removable   ()      const   { return header.removable; }
     void         removable   (bool b)        { header.removable = b; }
+    // added for DPS
+    bool         imported    ()      const   { return header.imported; }
+    void         imported    (bool b)        { header.imported = b; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool b)        { header.used = b; }
+    int          extras      ()      const   { return header.learnt ? 2 : (int)header.has_extra; }
+    bool         tagged      ()      const   { return header.tagged; }
+    uint32_t     source      ()      const   { assert(header.tagged); return data[header.size + extras()].abs; }
+    void         source      (uint32_t s)    { assert(header.tagged); data[header.size + extras()].abs = s; }
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
@@ -227,14 +244,14 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         RegionAllocator<uint32_t>::moveTo(to); }
 
     template<class Lits>
-    CRef alloc(const Lits& ps, bool learnt = false)
+    CRef alloc(const Lits& ps, bool learnt = false, bool tagged = false)
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         int extras = learnt ? 2 : (int)extra_clause_field;
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), extras));
-        new (lea(cid)) Clause(ps, extra_clause_field, learnt);
+        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), extras + (int)tagged));
+        new (lea(cid)) Clause(ps, extra_clause_field, learnt, tagged);
 
         return cid;
     }
@@ -250,7 +267,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
     {
         Clause& c = operator[](cid);
         int extras = c.learnt() ? 2 : (int)c.has_extra();
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), extras));
+        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), extras + (int)c.tagged()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -259,7 +276,8 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         
         if (c.reloced()) { cr = c.relocation(); return; }
         
-        cr = to.alloc(c, c.learnt());
+        cr = to.alloc(c, c.learnt(), c.tagged());
+        if (c.tagged()) to[cr].source(c.source());     // added for DPS
         c.relocate(cr);
         
         // Copy extra data-fields: 
@@ -270,6 +288,8 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
             to[cr].activity() = c.activity();
             to[cr].set_lbd(c.lbd());
             to[cr].removable(c.removable());
+            to[cr].imported(c.imported());  // added for DPS
+            to[cr].used(c.used());          // added for DPS
         }
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
     }
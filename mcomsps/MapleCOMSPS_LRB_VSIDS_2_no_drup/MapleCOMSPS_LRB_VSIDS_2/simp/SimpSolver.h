@@ -68,6 +68,10 @@ class SimpSolver : public Solver {
     bool    addClause (Lit p, Lit q);        // Add a binary clause to the solver.
     bool    addClause (Lit p, Lit q, Lit r); // Add a ternary clause to the solver.
     bool    addClause_(      vec<Lit>& ps);
+
+    // added for DPS
+    void    newVars   (int n);                                                          // Add variables up to 'n' at once.
+    bool    addClauses(const int* lits, const uint64_t* offsets, uint64_t num_clauses); // Add clauses in DIMACS representation at once.
     bool    substitute(Var v, Lit x);  // Replace all occurences of v with x (may cause a contradiction).
 
     // Variable mode:
@@ -87,6 +87,9 @@ Solver::Solver() :
 
     // added for DPS
   , wrapper(NULL)
+  , max_redundant(0)
+  , next_redundant_reduce(0)
+  , prob_confs(0)
 
   , ok                 (true)
   , cla_inc            (1)
@@ -282,6 +285,10 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     do{
         assert(confl != CRef_Undef); // (otherwise should be UIP)
         Clause& c = ca[confl];
+        if (c.tagged())     // added for DPS (the first clause is the conflict, the rest are reasons)
+            wrapper->useImportedClause(c.source(), p == lit_Undef);
+        if (c.imported())   // added for DPS (a clause on probation is used in conflict analysis)
+            c.used(true);
 
         if (c.learnt())
             claBumpActivity(c);
@@ -542,8 +549,10 @@ void Solver::reduceDB()
         Clause& c = ca[learnts[i]];
         if (c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
             removeClause(learnts[i]);
-        else
+        else {
+            if (c.tagged()) wrapper->retainImportedClause(c.source());    // added for DPS
             learnts[j++] = learnts[i];
+        }
     }
     learnts.shrink(i - j);
     checkGarbage();
@@ -628,20 +637,22 @@ lbool Solver::search(int nof_conflicts)
     starts++;
 
     for (;;){
+        CRef imported_confl = CRef_Undef;   // added for DPS
     	// added for DPS
         if (wrapper) {
             if (decisionLevel() == 0 || wrapper->shouldApplyImportedClauses()) 
-                if (applyImportedClauses() == false)
+                if (applyImportedClauses(imported_confl) == false)
                     return l_False;
             if (!wrapper->checkPeriod()) 
                 return l_Undef;
         }
 
-        CRef confl = propagate();
+        CRef confl = imported_confl != CRef_Undef ? imported_confl : propagate();   // modified for DPS
         if (confl != CRef_Undef){
             // CONFLICT
             conflicts++; conflictC++; 
             rand_pick_first_conflict = false;   // added by nabesima for DPS
+            if (conflicts == 1 && wrapper) wrapper->recordFirstConflict();  // added for DPS
             if (decisionLevel() == 0) return l_False;
 
             learnt_clause.clear();
@@ -691,9 +702,19 @@ lbool Solver::search(int nof_conflicts)
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
 
-            if (learnts.size()-nAssigns() >= max_learnts)
+            if (learnts.size()-nAssigns() >= max_learnts) {
                 // Reduce the set of learnt clauses:
                 reduceDB();
+                updateRedundantLimit();   // added for DPS
+            }
+            // added for DPS (the redundant clause limit given by the memory planner forces a reduction)
+            else if (max_redundant > 0 && (uint64_t)learnts.size() >= next_redundant_reduce) {
+                reduceDB();
+                updateRedundantLimit();
+            }
+            // added for DPS
+            if (probation.size() > 0 && probation[0].deadline <= conflicts)
+                reviewProbation();
 
             Lit next = lit_Undef;
             while (decisionLevel() < assumptions.size()){
@@ -926,6 +947,11 @@ void Solver::relocAll(ClauseAllocator& to)
     for (int i = 0; i < learnts.size(); i++)
         ca.reloc(learnts[i], to);
 
+    // All imported clauses on probation (added for DPS):
+    //
+    for (int i = 0; i < probation.size(); i++)
+        ca.reloc(probation[i].cr, to);
+
     // All original:
     //
     for (int i = 0; i < clauses.size(); i++)
@@ -947,57 +973,159 @@ void Solver::garbageCollect()
 }
 
 // added for DPS
-bool Solver::applyImportedClauses() {
+bool Solver::applyImportedClauses(CRef& confl) {
+    confl = CRef_Undef;
     if (wrapper == nullptr) return true;
-    //cout << "applyImportedClauses: unit clauses = " << wrapper->getImportedUnitClauses().size() << endl;
-    if (decisionLevel() > 0) { 
-        wrapper->incNumForcedApplications();
-        cancelUntil(0); 
-    }
-    
+
     wrapper->getChronometer().start(DPS::ExchangingTime);
-    // First, applies unit clauses
+    // First, applies unit clauses at the root level
     std::vector<DPS::Clause>& importedUnitClauses = wrapper->getImportedUnitClauses();
-    for (DPS::Clause& clause : importedUnitClauses) 
-        if (!applyImportedClause(clause)) {
-            ok = false;
-            break;
-        }
-    importedUnitClauses.clear();
-    // Then, applies non-unit clauses
+    if (importedUnitClauses.size() > 0 && (decisionLevel() == 0 || wrapper->shouldApplyImportedUnitClauses())) {
+        for (DPS::Clause& clause : importedUnitClauses) 
+            if (!applyImportedClause(clause, confl)) {
+                ok = false;
+                break;
+            }
+        importedUnitClauses.clear();
+    }
+    // Then, attaches non-unit clauses at the current decision level. If one of them is 
+    // falsified, the rest is applied after the conflict is analyzed.
     std::vector<DPS::Clause>& importedClauses = wrapper->getImportedClauses();
-    for (DPS::Clause& clause : importedClauses) 
-        if (!applyImportedClause(clause)) {
+    std::vector<uint32_t>& importedSources = wrapper->getImportedSources();
+    size_t applied = 0;
+    while (ok && applied < importedClauses.size() && confl == CRef_Undef) {
+        if (!applyImportedClause(importedClauses[applied], confl, importedSources[applied]))
             ok = false;
-            break;
-        }
-    importedClauses.clear();
+        applied++;
+    }
+    wrapper->eraseImportedClauses(applied);
     wrapper->getChronometer().stop(DPS::ExchangingTime);
 
     return ok;
 }
 
-bool Solver::applyImportedClause(DPS::Clause& clause) {
+bool Solver::applyImportedClause(DPS::Clause& clause, CRef& confl, uint32_t src) {
     add_tmp.clear();
     for (int n : clause) {
         Lit lit = n > 0 ? mkLit(n-1, false) : mkLit(-n-1, true);
-        if (value(lit) == l_False) continue;
-        if (value(lit) == l_True) return true;
+        if (value(lit) != l_Undef && level(var(lit)) == 0) {
+            if (value(lit) == l_True) return true;
+            continue;
+        }
         add_tmp.push(lit);
     }
     if (add_tmp.size() == 0) 
         return ok = false;
+    if (add_tmp.size() == 1 && clause.size() > 1 && decisionLevel() > 0) {
+        // a clause shrunk to a unit waits for the forced application of imported unit clauses
+        wrapper->deferImportedUnit(sign(add_tmp[0]) ? -(var(add_tmp[0]) + 1) : var(add_tmp[0]) + 1);
+        return true;
+    }
     wrapper->incNumImportedClauses();
     if (add_tmp.size() == 1) {
-        uncheckedEnqueue(add_tmp[0]);
-        if (propagate() != CRef_Undef) 
-            return false;
+        // a unit clause is asserted at the root level
+        if (decisionLevel() > 0) {
+            wrapper->incNumForcedApplications();
+            cancelUntil(0);
+        }
+        uncheckedEnqueue(add_tmp[0]);     // propagated together with other imported literals by 'search'
     }
     else {
-        CRef cr = ca.alloc(add_tmp, true);
-        learnts.push(cr);
-        attachClause(cr);
+        sortWatchCandidates(add_tmp);
+        CRef cr = ca.alloc(add_tmp, true, true);
+        ca[cr].source(src);               // tagged with the source thread for usefulness accounting
+        if (prob_confs > 0 && add_tmp.size() > 2) {
+            // non-binary clauses are on probation until reviewed by 'reviewProbation'
+            ca[cr].imported(true);
+            ProbationClause pc = { cr, conflicts + prob_confs };
+            probation.push(pc);
+        }
+        else
+            learnts.push(cr);
         claBumpActivity(ca[cr]);          
+        attachClause(cr);
+        if (value(add_tmp[1]) == l_False) {
+            int lv1 = level(var(add_tmp[1]));
+            if (value(add_tmp[0]) == l_Undef || level(var(add_tmp[0])) > lv1) {
+                // unit under the current trail (or satisfied only above the level of the second
+                // watch): propagates at the level of the second watch
+                cancelUntil(lv1);
+                uncheckedEnqueue(add_tmp[0], cr);
+                ca[cr].used(true);
+            }
+            else if (value(add_tmp[0]) == l_False) {
+                // falsified: analyzed as a conflict at its level
+                cancelUntil(lv1);
+                confl = cr;
+                ca[cr].used(true);
+            }
+        }
     }
     return true;
-}
\ No newline at end of file
+}
+
+// Moves the two best watch candidates to the front, i.e., true literals in increasing order
+// of decision level, unassigned literals and then false literals in decreasing order of
+// decision level.
+void Solver::sortWatchCandidates(vec<Lit>& lits) const {
+    for (int i = 0; i < 2; i++) {
+        int best = i;
+        for (int j = i + 1; j < lits.size(); j++)
+            if (watchPriority(lits[j]) > watchPriority(lits[best]))
+                best = j;
+        Lit tmp = lits[i]; lits[i] = lits[best]; lits[best] = tmp;
+    }
+}
+
+// Reviews imported clauses whose probation has expired. A clause that has been used as a
+// conflict or a reason is promoted to the learnt clauses, otherwise it is evicted.
+void Solver::reviewProbation() {
+    int i, j;
+    for (i = 0; i < probation.size() && probation[i].deadline <= conflicts; i++) {
+        CRef cr = probation[i].cr;
+        Clause& c = ca[cr];
+        c.imported(false);
+        if (c.used() || locked(c)) {
+            learnts.push(cr);
+            wrapper->promoteImportedClause(c.source());
+        }
+        else {
+            wrapper->evictImportedClause(c.source());
+            removeClause(cr);
+        }
+    }
+    for (j = 0; i < probation.size(); )
+        probation[j++] = probation[i++];
+    probation.shrink(i - j);
+}
+
+// added for DPS
+void Solver::updateRedundantLimit() {
+    // keep a gap of 'max_redundant/2' clauses between forced reductions if the database can not be reduced enough
+    if (max_redundant == 0) return;
+    uint64_t next = (uint64_t)learnts.size() + max_redundant / 2;
+    next_redundant_reduce = next < max_redundant ? max_redundant : next;
+}
+
+uint64_t Solver::memoryUsage() const {
+    // per-variable arrays (assigns, vardata, activity, polarity, decision, seen, trail, heap and watch lists)
+    const uint64_t bytes_per_var = sizeof(lbool) + sizeof(VarData) + sizeof(double) + 3 * sizeof(char)
+                                 + sizeof(Lit) + 2 * sizeof(int) + 2 * sizeof(vec<Watcher>);
+    uint64_t bytes = (uint64_t)nVars() * bytes_per_var;
+    bytes += (uint64_t)ca.size() * ClauseAllocator::Unit_Size;
+    bytes += (uint64_t)(clauses.size() + learnts.size() + probation.size()) * (2 * sizeof(Watcher) + sizeof(CRef));
+    return bytes;
+}
+
+uint64_t Solver::redundantBytes() const {
+    uint64_t bytes = 0;
+    for (int i = 0; i < learnts.size(); i++) {
+        const Clause& c = ca[learnts[i]];
+        bytes += sizeof(Clause) + sizeof(Lit) * (c.size() + (int)c.has_extra() + (int)c.tagged()) + 2 * sizeof(Watcher) + sizeof(CRef);
+    }
+    for (int i = 0; i < probation.size(); i++) {
+        const Clause& c = ca[probation[i].cr];
+        bytes += sizeof(Clause) + sizeof(Lit) * (c.size() + (int)c.has_extra() + (int)c.tagged()) + 2 * sizeof(Watcher) + sizeof(ProbationClause);
+    }
+    return bytes;
+}
@@ -23,6 +23,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_SolverTypes_h
 
 #include <assert.h>
+#include <stdexcept>
 
 // Include files should be specified relatively to avoid confusion with same named files.
 #include "../mtl/IntTypes.h"
@@ -138,18 +139,24 @@ class Clause {
         unsigned learnt    : 1;
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned size      : 27; }                            header;
+        unsigned imported  : 1;     // added for DPS (imported clause on probation)
+        unsigned used      : 1;     // added for DPS (used as a conflict or a reason while on probation)
+        unsigned tagged    : 1;     // added for DPS (imported clause with the source thread in the last word)
+        unsigned size      : 24; }                            header;   // modified for DPS (27 bits originally)
     union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
 
     friend class ClauseAllocator;
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     template<class V>
-    Clause(const V& ps, bool use_extra, bool learnt) {
+    Clause(const V& ps, bool use_extra, bool learnt, bool tagged = false) {
         header.mark      = 0;
         header.learnt    = learnt;
         header.has_extra = use_extra;
         header.reloced   = 0;
+        header.imported  = 0;       // added for DPS
+        header.used      = 0;       // added for DPS
+        header.tagged    = tagged;  // added for DPS
         header.size      = ps.size();
 
         for (int i = 0; i < ps.size(); i++) 
@@ -163,6 +170,8 @@ class Clause {
     }
 
 public:
+    static const int max_size = (1 << 24) - 1;   // added for DPS (the width of the size field)
+
     void calcAbstraction() {
         assert(header.has_extra);
         uint32_t abstraction = 0;
@@ -172,7 +181,9 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size];
+                                               if (header.tagged) data[header.size-i+header.has_extra] = data[header.size+header.has_extra];    // added for DPS
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
@@ -184,6 +195,15 @@ public:
     CRef         relocation  ()      const   { return data[0].rel; }
     void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
 
+    // added for DPS
+    bool         imported    ()      const   { return header.imported; }
+    void         imported    (bool b)        { header.imported = b; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool b)        { header.used = b; }
+    bool         tagged      ()      const   { return header.tagged; }
+    uint32_t     source      ()      const   { assert(header.tagged); return data[header.size + header.has_extra].abs; }
+    void         source      (uint32_t s)    { assert(header.tagged); data[header.size + header.has_extra].abs = s; }
+
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
     // modified by nabesima for counting the number of memory accesses
@@ -206,8 +226,8 @@ public:
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 class ClauseAllocator : public RegionAllocator<uint32_t>
 {
-    static int clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    static int clauseWord32Size(int size, int extras){     // modified for DPS (# of extra words instead of 'has_extra')
+        return (sizeof(Clause) + (sizeof(Lit) * (size + extras))) / sizeof(uint32_t); }
  public:
     bool extra_clause_field;
 
@@ -219,14 +239,17 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         RegionAllocator<uint32_t>::moveTo(to); }
 
     template<class Lits>
-    CRef alloc(const Lits& ps, bool learnt = false)
+    CRef alloc(const Lits& ps, bool learnt = false, bool tagged = false)
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
+        // added for DPS (a longer clause would be truncated by the size field)
+        if (ps.size() > Clause::max_size)
+            throw std::length_error("MiniSat does not support clauses of more than 2^24-1 literals");
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt);
+        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), (int)use_extra + (int)tagged));
+        new (lea(cid)) Clause(ps, use_extra, learnt, tagged);
 
         return cid;
     }
@@ -241,7 +264,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), (int)c.has_extra() + (int)c.tagged()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -250,12 +273,15 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         
         if (c.reloced()) { cr = c.relocation(); return; }
         
-        cr = to.alloc(c, c.learnt());
+        cr = to.alloc(c, c.learnt(), c.tagged());
+        if (c.tagged()) to[cr].source(c.source());     // added for DPS
         c.relocate(cr);
         
         // Copy extra data-fields: 
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
+        to[cr].imported(c.imported());  // added for DPS
+        to[cr].used(c.used());          // added for DPS
         if (to[cr].learnt())         to[cr].activity() = c.activity();
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
     }
@@ -54,6 +54,7 @@ class RegionAllocator
     }
 
 
+    void     reserve   (uint32_t n)  { capacity(sz + n); }  // added for DPS
     uint32_t size      () const      { return sz; }
     uint32_t wasted    () const      { return wasted_; }
 